@@ -1,14 +1,55 @@
 #include <iostream>
 #include <unordered_map>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <sstream>
+#include <cstdint>
+#include <climits>
+#include <type_traits>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+// Page number type for a given address width. 64-bit traces need 64-bit page
+// numbers; the 32-bit specialization keeps page numbers in packed ints so the
+// per-access arrays stay cache-dense. -1 is never a valid page number.
+template <typename Addr>
+struct AddressTraits {
+    typedef long long Page;
+};
+
+template <>
+struct AddressTraits<uint32_t> {
+    typedef int Page;
+};
+
 // Custom queue implementation (used for FIFO and LIFO)
+template <typename T>
 class Queue {
 private:
     int front, rear, size;
     int capacity;
-    int* array;
+    T* array;
 
 public:
     // Constructor to initialize queue
@@ -17,7 +58,7 @@ public:
         front = 0;
         rear = -1;
         size = 0;
-        array = new int[capacity];
+        array = new T[capacity];
     }
 
     // Destructor to free memory
@@ -36,7 +77,7 @@ public:
     }
 
     // Add page number to the queue (FIFO)
-    void enqueue(int pageNumber) {
+    void enqueue(T pageNumber) {
         if (isFull()) return; // Prevent enqueue if full
         rear = (rear + 1) % capacity;
         array[rear] = pageNumber;
@@ -44,18 +85,18 @@ public:
     }
 
     // Remove and return the front page number (FIFO)
-    int dequeue() {
+    T dequeue() {
         if (isEmpty()) return -1; // Return -1 if empty
-        int pageNumber = array[front];
+        T pageNumber = array[front];
         front = (front + 1) % capacity;
         size--;
         return pageNumber;
     }
 
     // Remove and return the element from the rear of the queue (for LIFO)
-    int dequeueRear() {
+    T dequeueRear() {
         if (isEmpty()) return -1; // Return -1 if empty
-        int pageNumber = array[rear];
+        T pageNumber = array[rear];
         rear = (rear - 1 + capacity) % capacity;
         size--;
         return pageNumber;
@@ -72,23 +113,39 @@ struct Node {
 };
 
 
-// FIFO TLB replacement algorithm
-int FIFO(int S, int P, int K, int N, unsigned int addresses[]) {
-    unordered_map<int, bool> tlbMap; // TLB map to track page numbers
-    Queue tlbQueue(K);               // Queue to handle FIFO
+// Translate a trace of addresses to page numbers once, up front.
+// Page sizes that are powers of two use a shift instead of a divide.
+template <typename Addr>
+void translatePages(int P, int N, const Addr addresses[], vector<typename AddressTraits<Addr>::Page>& pages) {
+    pages.resize(N > 0 ? N : 0);
+    Addr pageBytes = (Addr)P * 1024;
+    if ((pageBytes & (pageBytes - 1)) == 0) {
+        int shift = __builtin_ctzll(pageBytes);
+        for (int i = 0; i < N; i++) pages[i] = addresses[i] >> shift;
+    } else {
+        for (int i = 0; i < N; i++) pages[i] = addresses[i] / pageBytes;
+    }
+}
+
+
+// FIFO TLB replacement algorithm over a trace of page numbers.
+// Like every page kernel, it sets hitMask[i] to 1 for each access i that hits
+// when a zero-filled hitMask of N entries is given.
+template <typename Page>
+int FIFOPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    unordered_map<Page, bool> tlbMap; // TLB map to track page numbers
+    Queue<Page> tlbQueue(K);          // Queue to handle FIFO
     int tlbHits = 0;
 
     for (int i = 0; i < N; i++) {
-        unsigned int address = addresses[i];
-        //cout<<address<<" ";
-        int pageNumber = address / (P * 1024); // Calculate page number
-        //cout<<pageNumber<<" ";
+        Page pageNumber = pages[i];
         if (tlbMap.count(pageNumber)) { // Check if the page is in the TLB
             tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
         } else {
             // TLB miss
             if (tlbQueue.isFull()) {
-                int oldPage = tlbQueue.dequeue(); // Remove oldest page
+                Page oldPage = tlbQueue.dequeue(); // Remove oldest page
                 tlbMap.erase(oldPage);            // Erase from map
             }
             tlbQueue.enqueue(pageNumber);         // Add new page to queue
@@ -99,22 +156,23 @@ int FIFO(int S, int P, int K, int N, unsigned int addresses[]) {
     return tlbHits;
 }
 
-// LIFO TLB replacement algorithm
-int LIFO(int S, int P, int K, int N, unsigned int addresses[]) {
-    unordered_map<int, bool> tlbMap; // TLB map to track page numbers
-    Queue tlbQueue(K);               // Queue to handle LIFO
+// LIFO TLB replacement algorithm over a trace of page numbers
+template <typename Page>
+int LIFOPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    unordered_map<Page, bool> tlbMap; // TLB map to track page numbers
+    Queue<Page> tlbQueue(K);          // Queue to handle LIFO
     int tlbHits = 0;
 
     for (int i = 0; i < N; i++) {
-        unsigned int address = addresses[i];
-        int pageNumber = address / (P * 1024); // Calculate page number
+        Page pageNumber = pages[i];
 
         if (tlbMap.count(pageNumber)) { // Check if the page is in the TLB
             tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
         } else {
             // TLB miss
             if (tlbQueue.isFull()) {
-                int lastPage = tlbQueue.dequeueRear(); // Remove last added page (LIFO)
+                Page lastPage = tlbQueue.dequeueRear(); // Remove last added page (LIFO)
                 tlbMap.erase(lastPage);               // Erase from map
             }
             tlbQueue.enqueue(pageNumber);             // Add new page
@@ -125,17 +183,16 @@ int LIFO(int S, int P, int K, int N, unsigned int addresses[]) {
     return tlbHits;
 }
 
-// LRU TLB replacement algorithm
-// LRU TLB replacement algorithm
-int LRU(int S, int P, int K, int N, unsigned int addresses[]) {
+// Reference LRU over a trace of page numbers: heap-allocated list nodes and an
+// unordered_map. Kept to cross-check and benchmark the slab-based LRUPages below.
+int LRUListPages(int K, int N, const int pages[]) {
     unordered_map<int, Node*> tlbMap;  // Maps pageNumber to its node in the list
     Node* head = nullptr;              // Head of the doubly linked list
     Node* tail = nullptr;              // Tail of the doubly linked list
     int tlbHits = 0;
 
     for (int i = 0; i < N; i++) {
-        unsigned int address = addresses[i];
-        int pageNumber = address / (P * 1024); // Calculate page number
+        int pageNumber = pages[i];
 
         if (tlbMap.count(pageNumber)) { // Check if the page is in the TLB
             tlbHits++; // TLB hit
@@ -220,8 +277,127 @@ int LRU(int S, int P, int K, int N, unsigned int addresses[]) {
     return tlbHits;
 }
 
-// Optimal TLB replacement algorithm
-int Optimal(int S, int P, int K, int N, unsigned int addresses[]) 
+// Open-addressing hash map from page number to TLB slot (linear probing).
+// Sized once for a fixed number of keys, so inserts and erases never allocate.
+template <typename Page>
+class PageSlotMap {
+private:
+    vector<Page> keys; // Page number, or -1 for an empty bucket
+    vector<int> slots;
+    unsigned int mask;
+    int bits;
+
+    unsigned int bucketOf(Page page) const {
+        // Fibonacci hashing with the multiplier matching the key width
+        if (sizeof(Page) == 4) return ((uint32_t)page * 0x9E3779B1u) >> (32 - bits);
+        return ((uint64_t)page * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+    }
+
+public:
+    // Constructor to size the table for up to maxKeys entries at load <= 0.5
+    PageSlotMap(int maxKeys) {
+        unsigned int capacity = 16;
+        bits = 4;
+        while (capacity < 2u * (unsigned int)maxKeys) {
+            capacity <<= 1;
+            bits++;
+        }
+        mask = capacity - 1;
+        keys.assign(capacity, -1);
+        slots.assign(capacity, -1);
+    }
+
+    // Slot holding page, or -1 if absent
+    int find(Page page) const {
+        for (unsigned int b = bucketOf(page);; b = (b + 1) & mask) {
+            if (keys[b] == page) return slots[b];
+            if (keys[b] == -1) return -1;
+        }
+    }
+
+    // Insert a page known to be absent
+    void insert(Page page, int slot) {
+        unsigned int b = bucketOf(page);
+        while (keys[b] != -1) b = (b + 1) & mask;
+        keys[b] = page;
+        slots[b] = slot;
+    }
+
+    // Remove a page known to be present, shifting later probes back into the hole
+    void erase(Page page) {
+        unsigned int hole = bucketOf(page);
+        while (keys[hole] != page) hole = (hole + 1) & mask;
+        for (unsigned int b = (hole + 1) & mask; keys[b] != -1; b = (b + 1) & mask) {
+            unsigned int home = bucketOf(keys[b]);
+            // Move the entry if its home bucket is not cyclically in (hole, b]
+            if (((b - home) & mask) >= ((b - hole) & mask)) {
+                keys[hole] = keys[b];
+                slots[hole] = slots[b];
+                hole = b;
+            }
+        }
+        keys[hole] = -1;
+    }
+};
+
+// LRU TLB replacement algorithm over a trace of page numbers.
+// The recency list lives in a pre-sized slab of K entries linked by index and
+// pages are looked up once per access in a PageSlotMap, so the steady-state
+// loop does no heap allocation.
+template <typename Page>
+int LRUPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    if (K <= 0) return 0;
+    vector<Page> pageOf(K);
+    vector<int> prev(K), next(K);
+    PageSlotMap<Page> tlbMap(K);
+    int head = -1, tail = -1; // Most and least recently used slots
+    int used = 0;
+    int tlbHits = 0;
+
+    for (int i = 0; i < N; i++) {
+        Page pageNumber = pages[i];
+        int slot = tlbMap.find(pageNumber);
+
+        if (slot != -1) {
+            tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
+            if (slot == head) continue;
+            // Unlink the slot; it is not the head, so it has a predecessor
+            next[prev[slot]] = next[slot];
+            if (slot == tail) tail = prev[slot];
+            else prev[next[slot]] = prev[slot];
+        } else {
+            // TLB miss: take a fresh slot, or recycle the least recently used one
+            if (used < K) {
+                slot = used++;
+            } else {
+                slot = tail;
+                tlbMap.erase(pageOf[slot]);
+                if (head == tail) {
+                    head = -1;
+                } else {
+                    tail = prev[slot];
+                    next[tail] = -1;
+                }
+            }
+            pageOf[slot] = pageNumber;
+            tlbMap.insert(pageNumber, slot);
+            if (head == -1) tail = slot;
+        }
+
+        // Push the slot at the front of the list
+        prev[slot] = -1;
+        next[slot] = head;
+        if (head != -1) prev[head] = slot;
+        head = slot;
+    }
+
+    return tlbHits;
+}
+
+// Reference Optimal: scans the whole TLB for the farthest next use on every miss.
+// O(N*K); kept to cross-check and benchmark the heap-based Optimal below.
+int OptimalScan(int S, int P, int K, int N, unsigned int addresses[]) 
 {
     unordered_map<int, int> tlbMap; // TLB map to track page numbers
     unordered_map<int, int> nextUse; // Tracks next use index of each page
@@ -292,6 +468,1451 @@ int Optimal(int S, int P, int K, int N, unsigned int addresses[])
     return tlbHits;
 }
 
+// Indexed max-heap over TLB slots keyed on next use (used by Optimal)
+// Each slot's position in the heap is tracked so its key can be changed in O(log K).
+class IndexedMaxHeap {
+private:
+    vector<int> heap; // heap[i] = slot stored at heap position i
+    vector<int> pos;  // pos[slot] = position of slot in heap
+    vector<int> key;  // key[slot] = next use index of the page in that slot
+
+    void swapNodes(int a, int b) {
+        int slotA = heap[a], slotB = heap[b];
+        heap[a] = slotB;
+        heap[b] = slotA;
+        pos[slotB] = a;
+        pos[slotA] = b;
+    }
+
+    void siftUp(int i) {
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (key[heap[parent]] >= key[heap[i]]) break;
+            swapNodes(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(int i) {
+        int n = heap.size();
+        while (true) {
+            int largest = i;
+            int left = 2 * i + 1, right = 2 * i + 2;
+            if (left < n && key[heap[left]] > key[heap[largest]]) largest = left;
+            if (right < n && key[heap[right]] > key[heap[largest]]) largest = right;
+            if (largest == i) break;
+            swapNodes(i, largest);
+            i = largest;
+        }
+    }
+
+public:
+    // Constructor to reserve room for capacity slots
+    IndexedMaxHeap(int capacity) : pos(capacity, -1), key(capacity, 0) {
+        heap.reserve(capacity);
+    }
+
+    // Insert a new slot with the given key
+    void push(int slot, int k) {
+        key[slot] = k;
+        pos[slot] = heap.size();
+        heap.push_back(slot);
+        siftUp(pos[slot]);
+    }
+
+    // Change the key of a slot already in the heap
+    void update(int slot, int k) {
+        int old = key[slot];
+        key[slot] = k;
+        if (k > old) siftUp(pos[slot]);
+        else siftDown(pos[slot]);
+    }
+
+    // Slot with the largest key
+    int top() const {
+        return heap[0];
+    }
+};
+
+// Map page numbers to dense ids 0..U-1 so per-page state can live in plain arrays.
+// Returns U, the number of distinct pages.
+template <typename Page>
+int densePageIds(int N, const Page pages[], vector<int>& ids) {
+    unordered_map<Page, int> idOf;
+    idOf.reserve(N);
+    ids.resize(N > 0 ? N : 0);
+    int numPages = 0;
+    for (int i = 0; i < N; i++) {
+        auto it = idOf.emplace(pages[i], numPages);
+        if (it.second) numPages++;
+        ids[i] = it.first->second;
+    }
+    return numPages;
+}
+
+// nextUse[i] = index of the next access to the same page as access i, or N if
+// the page is never used again. ids are dense page ids from densePageIds().
+void computeNextUse(int N, const vector<int>& ids, int numPages, vector<int>& nextUse) {
+    nextUse.resize(N > 0 ? N : 0);
+    vector<int> lastSeen(numPages, N);
+    for (int i = N - 1; i >= 0; i--) {
+        nextUse[i] = lastSeen[ids[i]];
+        lastSeen[ids[i]] = i;
+    }
+}
+
+// Optimal (Belady) TLB replacement algorithm over a trace of page numbers
+// Next uses are precomputed into a dense array indexed by trace position, and the
+// resident pages are kept in an indexed max-heap keyed on next use, so a miss
+// costs O(log K) instead of a scan over the whole TLB.
+template <typename Page>
+int OptimalPages(int K, int N, const Page pages[], char hitMask[] = nullptr)
+{
+    if (N <= 0 || K <= 0) return 0;
+
+    // Map page numbers to dense ids so the main loop needs no hashing
+    vector<int> pageIds;
+    int numPages = densePageIds(N, pages, pageIds);
+
+    vector<int> nextUse;
+    computeNextUse(N, pageIds, numPages, nextUse);
+
+    vector<int> slotOf(numPages, -1); // slotOf[id] = TLB slot holding the page, or -1
+    vector<int> slotPages(K, -1);     // slotPages[slot] = dense id of the page in that slot
+    IndexedMaxHeap heap(K);
+    int used = 0;
+    int tlbHits = 0;
+
+    for (int i = 0; i < N; i++) {
+        int id = pageIds[i];
+        int slot = slotOf[id];
+
+        if (slot != -1) {
+            tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
+            heap.update(slot, nextUse[i]);
+        } else if (used < K) {
+            // TLB miss with a free slot
+            slot = used++;
+            slotPages[slot] = id;
+            slotOf[id] = slot;
+            heap.push(slot, nextUse[i]);
+        } else {
+            // TLB miss: evict the page whose next use is farthest away
+            slot = heap.top();
+            slotOf[slotPages[slot]] = -1;
+            slotPages[slot] = id;
+            slotOf[id] = slot;
+            heap.update(slot, nextUse[i]);
+        }
+    }
+
+    return tlbHits;
+}
+
+// CLOCK (second-chance) TLB replacement algorithm over a trace of page numbers.
+// Slots form a ring with one reference bit each; the hand clears set bits
+// until it finds a clear one to evict, which is O(1) amortized per access.
+template <typename Page>
+int CLOCKPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    if (K <= 0) return 0;
+    vector<Page> pageOf(K);
+    vector<char> referenced(K, 0);
+    PageSlotMap<Page> tlbMap(K);
+    int used = 0, hand = 0;
+    int tlbHits = 0;
+
+    for (int i = 0; i < N; i++) {
+        Page pageNumber = pages[i];
+        int slot = tlbMap.find(pageNumber);
+
+        if (slot != -1) {
+            tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
+            referenced[slot] = 1;
+            continue;
+        }
+
+        // TLB miss
+        if (used < K) {
+            slot = used++;
+        } else {
+            while (referenced[hand]) {
+                referenced[hand] = 0; // Second chance
+                hand = (hand + 1) % K;
+            }
+            slot = hand;
+            hand = (hand + 1) % K;
+            tlbMap.erase(pageOf[slot]);
+        }
+        pageOf[slot] = pageNumber;
+        referenced[slot] = 0;
+        tlbMap.insert(pageNumber, slot);
+    }
+
+    return tlbHits;
+}
+
+// LFU TLB replacement algorithm over a trace of page numbers.
+// Slots with the same use count share a recency-ordered bucket list, and the
+// smallest non-empty count is tracked, so every access is O(1). Ties are
+// broken by evicting the least recently used page of the smallest count;
+// counts start over when a page is evicted.
+template <typename Page>
+int LFUPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    if (K <= 0) return 0;
+    vector<Page> pageOf(K);
+    vector<int> count(K), prev(K), next(K);
+    vector<int> bucketHead(2, -1), bucketTail(2, -1); // Indexed by use count, MRU at head
+    PageSlotMap<Page> tlbMap(K);
+    int used = 0, minCount = 0;
+    int tlbHits = 0;
+
+    auto unlink = [&](int slot) {
+        int c = count[slot];
+        if (prev[slot] != -1) next[prev[slot]] = next[slot];
+        else bucketHead[c] = next[slot];
+        if (next[slot] != -1) prev[next[slot]] = prev[slot];
+        else bucketTail[c] = prev[slot];
+    };
+    auto pushFront = [&](int slot) {
+        int c = count[slot];
+        if (c >= (int)bucketHead.size()) {
+            bucketHead.resize(2 * c, -1);
+            bucketTail.resize(2 * c, -1);
+        }
+        prev[slot] = -1;
+        next[slot] = bucketHead[c];
+        if (bucketHead[c] != -1) prev[bucketHead[c]] = slot;
+        else bucketTail[c] = slot;
+        bucketHead[c] = slot;
+    };
+
+    for (int i = 0; i < N; i++) {
+        Page pageNumber = pages[i];
+        int slot = tlbMap.find(pageNumber);
+
+        if (slot != -1) {
+            tlbHits++; // TLB hit: move up one use count
+            if (hitMask) hitMask[i] = 1;
+            unlink(slot);
+            if (count[slot] == minCount && bucketHead[minCount] == -1) minCount++;
+            count[slot]++;
+            pushFront(slot);
+            continue;
+        }
+
+        // TLB miss: evict the least recently used page of the smallest count
+        if (used < K) {
+            slot = used++;
+        } else {
+            slot = bucketTail[minCount];
+            unlink(slot);
+            tlbMap.erase(pageOf[slot]);
+        }
+        pageOf[slot] = pageNumber;
+        count[slot] = 1;
+        minCount = 1;
+        pushFront(slot);
+        tlbMap.insert(pageNumber, slot);
+    }
+
+    return tlbHits;
+}
+
+// ARC (Adaptive Replacement Cache) TLB replacement algorithm over a trace of
+// page numbers, following Megiddo and Modha. Resident pages live in T1 (seen
+// once recently) and T2 (seen at least twice); B1 and B2 remember pages
+// recently evicted from each. Ghost hits move the target size p of T1. All
+// four lists share a slab of 2K nodes and one PageSlotMap, so accesses are O(1).
+template <typename Page>
+int ARCPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    if (K <= 0) return 0;
+    enum { T1, T2, B1, B2 };
+    int capacity = 2 * K;
+    vector<Page> pageOf(capacity);
+    vector<int> listOf(capacity), prev(capacity), next(capacity);
+    vector<int> freeNodes;
+    for (int n = capacity - 1; n >= 0; n--) freeNodes.push_back(n);
+    int head[4] = {-1, -1, -1, -1}, tail[4] = {-1, -1, -1, -1}, size[4] = {0, 0, 0, 0};
+    PageSlotMap<Page> nodeOf(capacity);
+    int p = 0; // Target size of T1
+    int tlbHits = 0;
+
+    auto unlink = [&](int node) {
+        int l = listOf[node];
+        if (prev[node] != -1) next[prev[node]] = next[node];
+        else head[l] = next[node];
+        if (next[node] != -1) prev[next[node]] = prev[node];
+        else tail[l] = prev[node];
+        size[l]--;
+    };
+    auto pushFront = [&](int node, int l) {
+        listOf[node] = l;
+        prev[node] = -1;
+        next[node] = head[l];
+        if (head[l] != -1) prev[head[l]] = node;
+        else tail[l] = node;
+        head[l] = node;
+        size[l]++;
+    };
+    // Drop the LRU page of a ghost list (or of T1) entirely
+    auto discardLRU = [&](int l) {
+        int node = tail[l];
+        unlink(node);
+        nodeOf.erase(pageOf[node]);
+        freeNodes.push_back(node);
+    };
+    // Evict a resident page into its ghost list
+    auto replace = [&](bool inB2) {
+        if (size[T1] > 0 && (size[T1] > p || (inB2 && size[T1] == p))) {
+            int node = tail[T1];
+            unlink(node);
+            pushFront(node, B1);
+        } else {
+            int node = tail[T2];
+            unlink(node);
+            pushFront(node, B2);
+        }
+    };
+
+    for (int i = 0; i < N; i++) {
+        Page pageNumber = pages[i];
+        int node = nodeOf.find(pageNumber);
+        int l = node != -1 ? listOf[node] : -1;
+
+        if (l == T1 || l == T2) {
+            tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
+            unlink(node);
+            pushFront(node, T2);
+        } else if (l == B1) {
+            p = min(K, p + max(size[B2] / size[B1], 1));
+            replace(false);
+            unlink(node);
+            pushFront(node, T2);
+        } else if (l == B2) {
+            p = max(0, p - max(size[B1] / size[B2], 1));
+            replace(true);
+            unlink(node);
+            pushFront(node, T2);
+        } else {
+            // Page not seen recently
+            if (size[T1] + size[B1] == K) {
+                if (size[T1] < K) {
+                    discardLRU(B1);
+                    replace(false);
+                } else {
+                    discardLRU(T1);
+                }
+            } else {
+                int total = size[T1] + size[T2] + size[B1] + size[B2];
+                if (total >= K) {
+                    if (total == 2 * K) discardLRU(B2);
+                    replace(false);
+                }
+            }
+            node = freeNodes.back();
+            freeNodes.pop_back();
+            pageOf[node] = pageNumber;
+            nodeOf.insert(pageNumber, node);
+            pushFront(node, T1);
+        }
+    }
+
+    return tlbHits;
+}
+
+// Seed used by the Random policy so runs are reproducible
+const unsigned int RANDOM_POLICY_SEED = 2021;
+
+// Random TLB replacement algorithm over a trace of page numbers: evicts a
+// uniformly chosen slot, drawn from a generator seeded with seed.
+template <typename Page>
+int RandomPagesSeeded(int K, int N, const Page pages[], unsigned int seed, char hitMask[] = nullptr) {
+    if (K <= 0) return 0;
+    vector<Page> pageOf(K);
+    PageSlotMap<Page> tlbMap(K);
+    mt19937 rng(seed);
+    int used = 0;
+    int tlbHits = 0;
+
+    for (int i = 0; i < N; i++) {
+        Page pageNumber = pages[i];
+        if (tlbMap.find(pageNumber) != -1) {
+            tlbHits++; // TLB hit
+            if (hitMask) hitMask[i] = 1;
+            continue;
+        }
+
+        // TLB miss
+        int slot;
+        if (used < K) {
+            slot = used++;
+        } else {
+            slot = rng() % K;
+            tlbMap.erase(pageOf[slot]);
+        }
+        pageOf[slot] = pageNumber;
+        tlbMap.insert(pageNumber, slot);
+    }
+
+    return tlbHits;
+}
+
+template <typename Page>
+int RandomPages(int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    return RandomPagesSeeded(K, N, pages, RANDOM_POLICY_SEED, hitMask);
+}
+
+// Address-based entry points: translate the trace, then run the page kernel
+template <typename Addr>
+int FIFO(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return FIFOPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int LIFO(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return LIFOPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int LRU(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return LRUPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int Optimal(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return OptimalPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int CLOCK(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return CLOCKPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int LFU(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return LFUPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int ARC(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return ARCPages(K, N, pages.data());
+}
+
+template <typename Addr>
+int Random(int S, int P, int K, int N, Addr addresses[]) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    return RandomPages(K, N, pages.data());
+}
+
+// Every fully associative policy, in output order for --extended
+const char* const policyNames[] = {"fifo", "lifo", "lru", "optimal", "clock", "lfu", "arc", "random"};
+const int NUM_POLICIES = sizeof(policyNames) / sizeof(policyNames[0]);
+
+// Run the page kernel of policy p (an index into policyNames)
+template <typename Page>
+int runPolicy(int p, int K, int N, const Page pages[], char hitMask[] = nullptr) {
+    switch (p) {
+        case 0: return FIFOPages(K, N, pages, hitMask);
+        case 1: return LIFOPages(K, N, pages, hitMask);
+        case 2: return LRUPages(K, N, pages, hitMask);
+        case 3: return OptimalPages(K, N, pages, hitMask);
+        case 4: return CLOCKPages(K, N, pages, hitMask);
+        case 5: return LFUPages(K, N, pages, hitMask);
+        case 6: return ARCPages(K, N, pages, hitMask);
+        default: return RandomPages(K, N, pages, hitMask);
+    }
+}
+
+// Hit counts of every policy for one test case
+struct PolicyHits {
+    int fifo, lifo, lru, opt;
+};
+
+// Run all four policies on one trace. The trace is translated to page numbers
+// once and the policies, which only read it, run on their own threads when the
+// trace is big enough to pay for them, so wall time tracks the slowest policy.
+// Callers that already run test cases in parallel pass parallel = false.
+template <typename Addr>
+PolicyHits runAllPolicies(int P, int K, int N, const Addr addresses[], bool parallel = true) {
+    typedef typename AddressTraits<Addr>::Page Page;
+    vector<Page> pages;
+    translatePages(P, N, addresses, pages);
+    const Page* trace = pages.data();
+    PolicyHits hits;
+
+    if (parallel && N >= 100000 && thread::hardware_concurrency() > 1) {
+        thread fifoThread([&] { hits.fifo = FIFOPages(K, N, trace); });
+        thread lifoThread([&] { hits.lifo = LIFOPages(K, N, trace); });
+        thread lruThread([&] { hits.lru = LRUPages(K, N, trace); });
+        hits.opt = OptimalPages(K, N, trace);
+        fifoThread.join();
+        lifoThread.join();
+        lruThread.join();
+    } else {
+        hits.fifo = FIFOPages(K, N, trace);
+        hits.lifo = LIFOPages(K, N, trace);
+        hits.lru = LRUPages(K, N, trace);
+        hits.opt = OptimalPages(K, N, trace);
+    }
+    return hits;
+}
+
+// Replacement policies that can be applied inside a TLB set
+enum ReplacementPolicy { POLICY_FIFO, POLICY_LIFO, POLICY_LRU, POLICY_OPTIMAL };
+
+// Way holding page among the first stride tags of a set, or -1. 32-bit tags
+// are compared 8 (AVX2) or 4 (SSE2) at a time, 64-bit tags 4 at a time with
+// AVX2; stride is a multiple of 8 and unused ways hold -1.
+static inline int findTag(const int* row, int stride, int page) {
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi32(page);
+    for (int w = 0; w < stride; w += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(row + w)), key);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask) return w + __builtin_ctz(mask);
+    }
+    return -1;
+#elif defined(__SSE2__)
+    __m128i key = _mm_set1_epi32(page);
+    for (int w = 0; w < stride; w += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(row + w)), key);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if (mask) return w + __builtin_ctz(mask);
+    }
+    return -1;
+#else
+    for (int w = 0; w < stride; w++) {
+        if (row[w] == page) return w;
+    }
+    return -1;
+#endif
+}
+
+static inline int findTag(const long long* row, int stride, long long page) {
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi64x(page);
+    for (int w = 0; w < stride; w += 4) {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(row + w)), key);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask) return w + __builtin_ctz(mask);
+    }
+    return -1;
+#else
+    for (int w = 0; w < stride; w++) {
+        if (row[w] == page) return w;
+    }
+    return -1;
+#endif
+}
+
+// N-way set-associative TLB. Each set is a small fixed array of page tags
+// (padded to a multiple of 8 ways) probed with SIMD compares; the replacement
+// policy is applied within the set. With one set of K ways it behaves exactly
+// like the fully associative FIFO/LIFO/LRU/Optimal above.
+template <typename Page>
+class SetAssocTLB {
+private:
+    int numSets, ways, stride;
+    ReplacementPolicy policy;
+    vector<Page> tags;    // numSets * stride page numbers, -1 = invalid
+    vector<int> stamps;   // Per way: last use (LRU) or next use (Optimal)
+    vector<int> filled;   // Valid ways per set
+    vector<int> cursor;   // Per set: next FIFO victim, or last LIFO insert
+
+    int setOf(Page page) const {
+        return (numSets & (numSets - 1)) == 0 ? (int)(page & (numSets - 1)) : (int)(page % numSets);
+    }
+
+public:
+    // Constructor: entries total entries split into sets of the given ways.
+    // entries must be a multiple of ways (callers check), or every entry is one set.
+    SetAssocTLB(int entries, int ways, ReplacementPolicy policy) : policy(policy) {
+        if (ways < 1) ways = 1;
+        if (ways > entries) ways = entries;
+        this->ways = ways;
+        numSets = entries / ways > 0 ? entries / ways : 1;
+        stride = (ways + 7) & ~7;
+        tags.assign((size_t)numSets * stride, -1);
+        stamps.assign((size_t)numSets * stride, 0);
+        filled.assign(numSets, 0);
+        cursor.assign(numSets, 0);
+    }
+
+    // Look up page for access i (nextUse is only used by Optimal).
+    // Returns true on a hit; on a miss the page is filled, evicting if needed.
+    bool access(Page page, int i, int nextUse) {
+        int set = setOf(page);
+        Page* row = &tags[(size_t)set * stride];
+        int* stamp = &stamps[(size_t)set * stride];
+        int way = findTag(row, stride, page);
+
+        if (way != -1) {
+            if (policy == POLICY_LRU) stamp[way] = i;
+            else if (policy == POLICY_OPTIMAL) stamp[way] = nextUse;
+            return true;
+        }
+
+        if (filled[set] < ways) {
+            way = filled[set]++;
+            if (policy == POLICY_LIFO) cursor[set] = way;
+        } else if (policy == POLICY_FIFO) {
+            way = cursor[set];
+            cursor[set] = (way + 1) % ways;
+        } else if (policy == POLICY_LIFO) {
+            way = cursor[set]; // The newest page is always the one replaced
+        } else {
+            // LRU evicts the smallest last use, Optimal the largest next use
+            way = 0;
+            for (int w = 1; w < ways; w++) {
+                bool better = policy == POLICY_LRU ? stamp[w] < stamp[way] : stamp[w] > stamp[way];
+                if (better) way = w;
+            }
+        }
+
+        row[way] = page;
+        stamp[way] = policy == POLICY_OPTIMAL ? nextUse : i;
+        return false;
+    }
+};
+
+// Hit counts of every policy on a K-entry, WAYS-way set-associative TLB
+template <typename Addr>
+PolicyHits runSetAssociative(int P, int K, int ways, int N, const Addr addresses[]) {
+    typedef typename AddressTraits<Addr>::Page Page;
+    vector<Page> pages;
+    vector<int> ids, nextUse;
+    translatePages(P, N, addresses, pages);
+    int numPages = densePageIds(N, pages.data(), ids);
+    computeNextUse(N, ids, numPages, nextUse);
+
+    PolicyHits hits;
+    int* results[] = {&hits.fifo, &hits.lifo, &hits.lru, &hits.opt};
+    ReplacementPolicy policies[] = {POLICY_FIFO, POLICY_LIFO, POLICY_LRU, POLICY_OPTIMAL};
+    for (int p = 0; p < 4; p++) {
+        if (K <= 0) {
+            *results[p] = 0;
+            continue;
+        }
+        SetAssocTLB<Page> tlb(K, ways, policies[p]);
+        int tlbHits = 0;
+        for (int i = 0; i < N; i++) {
+            tlbHits += tlb.access(pages[i], i, nextUse[i]);
+        }
+        *results[p] = tlbHits;
+    }
+    return hits;
+}
+
+// Configuration of one level of a TLB hierarchy
+struct TLBLevelConfig {
+    int entries;
+    int ways;                  // ways >= entries means fully associative
+    ReplacementPolicy policy;
+};
+
+// Per-level results of a run through a two-level TLB hierarchy
+struct HierarchyStats {
+    long long l1Hits, l2Hits, misses;
+    double avgCycles;          // Average translation latency per access
+};
+
+// Parse "ENTRIES,WAYS,POLICY" (POLICY is fifo, lifo or lru); WAYS 0 = fully associative
+bool parseLevelConfig(const char* text, TLBLevelConfig& level) {
+    char name[16] = "";
+    if (sscanf(text, "%d,%d,%15s", &level.entries, &level.ways, name) != 3 || level.entries <= 0) {
+        return false;
+    }
+    if (level.ways <= 0) level.ways = level.entries;
+    if (level.ways < level.entries && level.entries % level.ways != 0) {
+        return false; // Sets would leave entries % ways entries unused
+    }
+    if (strcmp(name, "fifo") == 0) level.policy = POLICY_FIFO;
+    else if (strcmp(name, "lifo") == 0) level.policy = POLICY_LIFO;
+    else if (strcmp(name, "lru") == 0) level.policy = POLICY_LRU;
+    else return false;
+    return true;
+}
+
+// Run a trace through an L1 TLB backed by a larger L2 TLB. L2 is only probed
+// (and only updates its replacement state) on L1 misses; misses in both levels
+// fill both. An access costs l1Cycles, plus l2Cycles if it reaches L2, plus
+// missCycles if it misses in both.
+template <typename Addr>
+HierarchyStats runHierarchy(int P, int N, const Addr addresses[],
+                            const TLBLevelConfig& l1, const TLBLevelConfig& l2,
+                            int l1Cycles, int l2Cycles, int missCycles) {
+    typedef typename AddressTraits<Addr>::Page Page;
+    vector<Page> pages;
+    translatePages(P, N, addresses, pages);
+    SetAssocTLB<Page> first(l1.entries, l1.ways, l1.policy);
+    SetAssocTLB<Page> second(l2.entries, l2.ways, l2.policy);
+
+    HierarchyStats stats = {0, 0, 0, 0.0};
+    for (int i = 0; i < N; i++) {
+        if (first.access(pages[i], i, 0)) {
+            stats.l1Hits++;
+        } else if (second.access(pages[i], i, 0)) {
+            stats.l2Hits++;
+        } else {
+            stats.misses++;
+        }
+    }
+
+    if (N > 0) {
+        double cycles = (double)N * l1Cycles + (double)(N - stats.l1Hits) * l2Cycles
+                      + (double)stats.misses * missCycles;
+        stats.avgCycles = cycles / N;
+    }
+    return stats;
+}
+
+// Address range [start, end] mapped with pages of pageBytes bytes
+struct PageSizeRegion {
+    unsigned long long start, end;
+    unsigned int pageBytes;
+};
+
+// Parse a size such as 4096, 4K, 2M or 1G into bytes
+static unsigned long long parseSize(const char* text) {
+    char* rest;
+    unsigned long long value = strtoull(text, &rest, 0);
+    switch (*rest) {
+        case 'k': case 'K': return value << 10;
+        case 'm': case 'M': return value << 20;
+        case 'g': case 'G': return value << 30;
+        default: return value;
+    }
+}
+
+// Load a page-size map: one "START END SIZE" line per region, START and END
+// inclusive hex addresses, SIZE like 4K, 2M or 1G. Lines starting with # are skipped.
+bool loadPageSizeMap(const char* path, vector<PageSizeRegion>& regions) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char start[64], end[64], size[64];
+        if (line[0] == '#' || sscanf(line, "%63s %63s %63s", start, end, size) != 3) continue;
+        PageSizeRegion region;
+        region.start = strtoull(start, nullptr, 16);
+        region.end = strtoull(end, nullptr, 16);
+        region.pageBytes = (unsigned int)parseSize(size);
+        if (region.pageBytes == 0 || region.end < region.start) {
+            cerr << "Bad page-size region: " << line;
+            fclose(file);
+            return false;
+        }
+        regions.push_back(region);
+    }
+    fclose(file);
+    sort(regions.begin(), regions.end(), [](const PageSizeRegion& a, const PageSizeRegion& b) {
+        return a.start < b.start;
+    });
+    return true;
+}
+
+// Run the policies on a trace that mixes page sizes. Addresses outside every
+// region use the test case's P KiB pages. Page sizes form classes in
+// ascending size order. With splitEntries empty, one unified K-entry TLB is
+// shared by all sizes, tagged with the size class; otherwise class c gets its
+// own TLB of splitEntries[c] entries and the hits of all arrays are summed.
+template <typename Addr>
+PolicyHits runMixedPageSizes(int P, int K, int N, const Addr addresses[],
+                             const vector<PageSizeRegion>& regions, const vector<int>& splitEntries) {
+    typedef typename AddressTraits<Addr>::Page Page;
+    vector<unsigned long long> sizes(1, (unsigned long long)P * 1024);
+    for (const PageSizeRegion& region : regions) sizes.push_back(region.pageBytes);
+    sort(sizes.begin(), sizes.end());
+    sizes.erase(unique(sizes.begin(), sizes.end()), sizes.end());
+    int numClasses = sizes.size();
+
+    vector<int> regionClass(regions.size());
+    for (size_t r = 0; r < regions.size(); r++) {
+        regionClass[r] = lower_bound(sizes.begin(), sizes.end(), regions[r].pageBytes) - sizes.begin();
+    }
+    int baseClass = lower_bound(sizes.begin(), sizes.end(), (unsigned long long)P * 1024) - sizes.begin();
+
+    // Translate each address with the page size of its region
+    vector<Page> pages(N > 0 ? N : 0);
+    vector<int> classOf(N > 0 ? N : 0);
+    for (int i = 0; i < N; i++) {
+        Addr address = addresses[i];
+        int c = baseClass;
+        auto it = upper_bound(regions.begin(), regions.end(), address,
+                              [](unsigned long long a, const PageSizeRegion& r) { return a < r.start; });
+        if (it != regions.begin() && address <= (it - 1)->end) {
+            c = regionClass[it - 1 - regions.begin()];
+        }
+        classOf[i] = c;
+        pages[i] = (Page)(address / sizes[c]);
+    }
+
+    PolicyHits hits = {0, 0, 0, 0};
+    if (splitEntries.empty()) {
+        // Unified TLB: tag each page number with its size class
+        for (int i = 0; i < N; i++) pages[i] = pages[i] * numClasses + classOf[i];
+        hits.fifo = FIFOPages(K, N, pages.data());
+        hits.lifo = LIFOPages(K, N, pages.data());
+        hits.lru = LRUPages(K, N, pages.data());
+        hits.opt = OptimalPages(K, N, pages.data());
+        return hits;
+    }
+
+    // Separate TLB per size class, each fed the subsequence of its accesses
+    vector<Page> subset;
+    for (int c = 0; c < numClasses; c++) {
+        int entries = c < (int)splitEntries.size() ? splitEntries[c] : 0;
+        if (entries <= 0) continue;
+        subset.clear();
+        for (int i = 0; i < N; i++) {
+            if (classOf[i] == c) subset.push_back(pages[i]);
+        }
+        int n = subset.size();
+        hits.fifo += FIFOPages(entries, n, subset.data());
+        hits.lifo += LIFOPages(entries, n, subset.data());
+        hits.lru += LRUPages(entries, n, subset.data());
+        hits.opt += OptimalPages(entries, n, subset.data());
+    }
+    return hits;
+}
+
+// Shape and costs of the radix page table walked on a TLB miss
+struct PageWalkConfig {
+    vector<int> levelBits = {2}; // Bits per level, top first; a single entry is a level count
+    int pwcEntries = 16;    // Page-walk cache entries (fully associative LRU), 0 = none
+    int tlbCycles = 1;      // Cost of every TLB lookup
+    int pwcCycles = 2;      // Cost of probing the page-walk cache on a miss
+    int memCycles = 50;     // Cost of each page-table memory reference
+};
+
+// Parse "L" (L levels) or "B1,B2,...,BL" (explicit bits per level, top first)
+bool parseWalkShape(const char* text, vector<int>& levelBits) {
+    levelBits.clear();
+    for (const char* p = text; *p;) {
+        char* rest;
+        long bits = strtol(p, &rest, 10);
+        if (rest == p || bits <= 0) return false;
+        levelBits.push_back(bits);
+        p = *rest == ',' ? rest + 1 : rest;
+        if (*rest && *rest != ',') return false;
+    }
+    return !levelBits.empty();
+}
+
+// Bits per level for a VPN of vpnBits bits. A single configured value is a
+// level count and the bits are split as evenly as possible, upper levels
+// taking the extra bits; explicit widths are used as given except that the
+// top level absorbs any difference from vpnBits.
+static vector<int> walkLevels(const vector<int>& config, int vpnBits) {
+    vector<int> bits;
+    if (config.size() == 1) {
+        int levels = max(1, min(config[0], vpnBits));
+        for (int l = 0; l < levels; l++) bits.push_back(vpnBits / levels + (l < vpnBits % levels));
+        return bits;
+    }
+    bits = config;
+    int lower = 0;
+    for (size_t l = 1; l < bits.size(); l++) lower += bits[l];
+    bits[0] = max(1, vpnBits - lower);
+    return bits;
+}
+
+// Total translation cycles of each policy in policyNames on one trace.
+// The virtual address space is S MiB of P KiB pages (widened if the trace
+// touches higher pages), translated by a radix table shaped by config. Every
+// access pays a TLB lookup; a miss probes the page-walk cache for the deepest
+// cached upper-level entry and pays one memory reference for every level
+// below it, including the leaf PTE.
+template <typename Addr>
+vector<long long> runPageWalks(int S, int P, int K, int N, const Addr addresses[],
+                               const PageWalkConfig& config) {
+    typedef typename AddressTraits<Addr>::Page Page;
+    vector<Page> pages;
+    translatePages(P, N, addresses, pages);
+
+    unsigned long long pageBytes = (unsigned long long)P * 1024;
+    unsigned long long maxPage = ((unsigned long long)S << 20) / pageBytes;
+    for (int i = 0; i < N; i++) maxPage = max(maxPage, (unsigned long long)pages[i] + 1);
+    int vpnBits = 1;
+    while ((1ULL << vpnBits) < maxPage) vpnBits++;
+    vector<int> bits = walkLevels(config.levelBits, vpnBits);
+    int levels = bits.size();
+
+    // shiftBelow[d] = VPN bits below the first d levels, so vpn >> shiftBelow[d]
+    // identifies the table reached after walking d levels
+    vector<int> shiftBelow(levels + 1, 0);
+    for (int d = levels - 1; d >= 0; d--) shiftBelow[d] = shiftBelow[d + 1] + bits[d];
+
+    vector<long long> cycles;
+    vector<char> hitMask(N > 0 ? N : 0);
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        fill(hitMask.begin(), hitMask.end(), 0);
+        int hits = runPolicy(p, K, N, pages.data(), hitMask.data());
+        long long total = (long long)N * config.tlbCycles;
+        if (config.pwcEntries <= 0) {
+            total += (long long)(N - hits) * levels * config.memCycles;
+            cycles.push_back(total);
+            continue;
+        }
+
+        SetAssocTLB<Page> pwc(config.pwcEntries, config.pwcEntries, POLICY_LRU);
+        for (int i = 0; i < N; i++) {
+            if (hitMask[i]) continue;
+            // Entry for the table after d levels: key = prefix * levels + d, unique for any depth
+            int skipped = 0;
+            for (int d = levels - 1; d >= 1; d--) {
+                Page key = (Page)(((unsigned long long)pages[i] >> shiftBelow[d]) * levels + d);
+                if (pwc.access(key, i, 0)) {
+                    skipped = d;
+                    break;
+                }
+            }
+            total += config.pwcCycles + (long long)(levels - skipped) * config.memCycles;
+        }
+        cycles.push_back(total);
+    }
+    return cycles;
+}
+
+// Fenwick (binary indexed) tree of counts over trace positions
+class FenwickTree {
+private:
+    vector<int> tree;
+
+public:
+    FenwickTree(int n) : tree(n + 1, 0) {}
+
+    // Add delta at position i (0-based)
+    void add(int i, int delta) {
+        for (i++; i < (int)tree.size(); i += i & -i) tree[i] += delta;
+    }
+
+    // Sum of positions 0..i-1
+    int prefix(int i) const {
+        int sum = 0;
+        for (; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+};
+
+// LRU stack distance (Mattson) histogram over a page trace in O(N log N).
+// Each page's most recent access position is marked in a Fenwick tree, so the
+// number of distinct pages touched since the previous access to the same page
+// is a range count. distances[d] = number of accesses with stack distance d
+// (1-based); cold misses are not counted.
+template <typename Page>
+void stackDistances(int N, const Page pages[], vector<long long>& distances) {
+    vector<int> ids;
+    int numPages = densePageIds(N, pages, ids);
+    vector<int> lastAccess(numPages, -1);
+    FenwickTree marks(N);
+    distances.assign(numPages + 1, 0);
+
+    for (int i = 0; i < N; i++) {
+        int last = lastAccess[ids[i]];
+        if (last != -1) {
+            int distance = marks.prefix(i) - marks.prefix(last + 1) + 1;
+            distances[distance]++;
+            marks.add(last, -1);
+        }
+        marks.add(i, 1);
+        lastAccess[ids[i]] = i;
+    }
+}
+
+// Print the LRU miss-ratio curve for K = 1..maxK as CSV rows
+// (case,K,hits,miss_ratio); hits for a given K match LRU() with that K.
+template <typename Addr>
+void printMissRatioCurve(ostream& out, int testCase, int P, int N, const Addr addresses[], int maxK) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    vector<long long> distances;
+    stackDistances(N, pages.data(), distances);
+
+    long long hits = 0;
+    for (int K = 1; K <= maxK; K++) {
+        if (K < (int)distances.size()) hits += distances[K];
+        double missRatio = N > 0 ? (double)(N - hits) / N : 0.0;
+        out << testCase << "," << K << "," << hits << "," << missRatio << "\n";
+    }
+}
+
+// Spatial hash used to pick SHARDS samples, so a page is either always or
+// never in the sample
+inline uint64_t shardsHash(unsigned long long page) {
+    uint64_t x = page + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+const uint64_t SHARDS_MODULUS = 1ULL << 24;
+
+// Estimated LRU hits for K = 1..maxK (hits[K]) by SHARDS spatial sampling.
+// Only pages with hash mod M below rate * M are simulated, and d - 1 sampled
+// pages between reuses stand for (d - 1) / rate pages. Counts are scaled by
+// 1 / rate, and (SHARDS-adj) the smallest distance absorbs the difference
+// between the expected N * rate and the actual number of sampled accesses,
+// which cancels most of the bias of sampling a few very hot or cold pages.
+// Returns the number of sampled accesses.
+template <typename Page>
+int sampledLRUHits(int N, const Page pages[], double rate, int maxK, vector<double>& hits) {
+    uint64_t threshold = (uint64_t)(rate * SHARDS_MODULUS);
+    double scale = (double)threshold / SHARDS_MODULUS;
+    vector<Page> sample;
+    for (int i = 0; i < N; i++) {
+        if ((shardsHash(pages[i]) & (SHARDS_MODULUS - 1)) < threshold) sample.push_back(pages[i]);
+    }
+    int sampled = (int)sample.size();
+
+    hits.assign(maxK + 1, 0.0);
+    if (sampled == 0) return 0;
+    vector<long long> distances;
+    stackDistances(sampled, sample.data(), distances);
+    for (size_t d = 1; d < distances.size(); d++) {
+        long long scaled = (long long)((d - 1) / scale + 0.5) + 1;
+        if (distances[d] && scaled <= maxK) hits[scaled] += distances[d] / scale;
+    }
+    if (maxK >= 1) hits[1] += N - sampled / scale; // (N * rate - sampled) / rate
+
+    double total = 0;
+    for (int K = 1; K <= maxK; K++) {
+        total += hits[K];
+        hits[K] = min((double)N, max(0.0, total));
+    }
+    return sampled;
+}
+
+// Sampled counterpart of printMissRatioCurve: CSV rows for K = 1..maxK, or
+// with maxK = 0 just the estimated LRU() hits for K. A "#" line follows with
+// the sample size; sampling is per page, so a per-access binomial error would
+// not bound the estimate, and verify instead runs the exact curve and reports
+// the measured max and mean absolute miss-ratio error.
+template <typename Addr>
+void printSampledLRU(ostream& out, int testCase, int P, int K, int N, const Addr addresses[],
+                     int maxK, double rate, bool verify) {
+    vector<typename AddressTraits<Addr>::Page> pages;
+    translatePages(P, N, addresses, pages);
+    int lo = maxK > 0 ? 1 : K, hi = maxK > 0 ? maxK : K;
+    vector<double> hits;
+    int sampled = sampledLRUHits(N, pages.data(), rate, hi, hits);
+
+    for (int k = lo; k <= hi; k++) {
+        double missRatio = N > 0 ? (N - hits[k]) / N : 0.0;
+        if (maxK > 0) {
+            out << testCase << "," << k << "," << (long long)(hits[k] + 0.5) << "," << missRatio << "\n";
+        }
+    }
+    if (maxK == 0) out << (long long)(hits[max(K, 0)] + 0.5) << "\n";
+
+    out << "# case " << testCase << ": sampled " << sampled << " of " << N
+        << " accesses (rate " << rate << ")";
+    if (verify && N > 0 && hi >= lo) {
+        vector<long long> distances;
+        stackDistances(N, pages.data(), distances);
+        long long exact = 0;
+        double maxError = 0, sumError = 0;
+        for (int k = 1; k <= hi; k++) {
+            if (k < (int)distances.size()) exact += distances[k];
+            if (k < lo) continue;
+            double error = fabs(hits[k] - exact) / N;
+            maxError = max(maxError, error);
+            sumError += error;
+        }
+        out << ", max_abs_error " << maxError << ", mean_abs_error " << sumError / (hi - lo + 1);
+    }
+    out << endl;
+}
+
+// Generate a synthetic address trace: a drifting hot working set with random noise
+void makeSyntheticTrace(vector<unsigned int>& addresses, int N, int P, int workingSet, unsigned int seed) {
+    mt19937 rng(seed);
+    unsigned int pageBytes = P * 1024;
+    addresses.resize(N);
+    int base = 0;
+    for (int i = 0; i < N; i++) {
+        if (i % 4096 == 0) base += workingSet / 8; // Slowly shift the working set
+        unsigned int page;
+        if (rng() % 10 == 0) {
+            page = rng() % (unsigned int)(workingSet * 16);
+        } else {
+            page = base + rng() % (unsigned int)workingSet;
+        }
+        addresses[i] = page * pageBytes + rng() % pageBytes;
+    }
+}
+
+// Benchmark the heap-based Optimal against the reference scan on synthetic traces
+void benchOptimal(int N) {
+    int P = 4;
+    int sizes[] = {64, 256, 1024};
+    vector<unsigned int> addresses;
+
+    cout << "K,N,scan_hits,heap_hits,scan_ms,heap_ms,speedup" << endl;
+    for (int K : sizes) {
+        makeSyntheticTrace(addresses, N, P, 4 * K, 42 + K);
+
+        auto t0 = chrono::steady_clock::now();
+        int scanHits = OptimalScan(0, P, K, N, addresses.data());
+        auto t1 = chrono::steady_clock::now();
+        int heapHits = Optimal(0, P, K, N, addresses.data());
+        auto t2 = chrono::steady_clock::now();
+
+        double scanMs = chrono::duration<double, milli>(t1 - t0).count();
+        double heapMs = chrono::duration<double, milli>(t2 - t1).count();
+        cout << K << "," << N << "," << scanHits << "," << heapHits << ","
+             << scanMs << "," << heapMs << "," << scanMs / heapMs << endl;
+        if (scanHits != heapHits) {
+            cerr << "Optimal mismatch for K=" << K << endl;
+        }
+    }
+}
+
+// Microbenchmark: accesses/second of the slab LRU against the list-based reference
+void benchLRU(int N) {
+    int P = 4;
+    int sizes[] = {16, 64, 256, 1024, 4096};
+    vector<unsigned int> addresses;
+    vector<int> pages;
+
+    cout << "K,N,list_hits,slab_hits,list_maccess_per_s,slab_maccess_per_s,speedup" << endl;
+    for (int K : sizes) {
+        makeSyntheticTrace(addresses, N, P, 2 * K, 7 + K);
+        translatePages(P, N, addresses.data(), pages);
+
+        auto t0 = chrono::steady_clock::now();
+        int listHits = LRUListPages(K, N, pages.data());
+        auto t1 = chrono::steady_clock::now();
+        int slabHits = LRUPages(K, N, pages.data());
+        auto t2 = chrono::steady_clock::now();
+
+        double listRate = N / chrono::duration<double, micro>(t1 - t0).count();
+        double slabRate = N / chrono::duration<double, micro>(t2 - t1).count();
+        cout << K << "," << N << "," << listHits << "," << slabHits << ","
+             << listRate << "," << slabRate << "," << slabRate / listRate << endl;
+        if (listHits != slabHits) {
+            cerr << "LRU mismatch for K=" << K << endl;
+        }
+    }
+}
+
+// Workload shapes produced by generateTrace
+const char* const traceKinds[] = {"sequential", "strided", "zipf", "phases", "loop", "drift"};
+const int NUM_TRACE_KINDS = sizeof(traceKinds) / sizeof(traceKinds[0]);
+
+// Generate N addresses of a named synthetic workload for a K-entry TLB of P KiB pages.
+//   sequential: 64-byte steps through a region of 16K pages, wrapping around
+//   strided:    one access every 3 pages plus 64 bytes, over 16K pages
+//   zipf:       pages drawn from a Zipf(1.0) distribution over 16K pages
+//   phases:     uniform accesses to a K/2-page working set that moves every N/8
+//   loop:       repeated scans of 2K pages, more than the TLB can hold
+//   drift:      makeSyntheticTrace with a 4K-page working set
+// Returns false for an unknown kind.
+bool generateTrace(const char* kind, int N, int P, int K, unsigned int seed, vector<uint32_t>& addresses) {
+    mt19937 rng(seed);
+    uint32_t pageBytes = P * 1024;
+    uint32_t region = 16 * (uint32_t)max(K, 1); // Pages touched by the scan-like workloads
+    addresses.resize(N > 0 ? N : 0);
+
+    if (strcmp(kind, "sequential") == 0) {
+        uint64_t span = (uint64_t)region * pageBytes;
+        for (int i = 0; i < N; i++) addresses[i] = ((uint64_t)i * 64) % span;
+    } else if (strcmp(kind, "strided") == 0) {
+        uint64_t span = (uint64_t)region * pageBytes;
+        for (int i = 0; i < N; i++) addresses[i] = ((uint64_t)i * (3 * pageBytes + 64)) % span;
+    } else if (strcmp(kind, "zipf") == 0) {
+        // Inverse-CDF sampling; rank r has weight 1 / (r + 1)
+        vector<double> cdf(region);
+        double total = 0;
+        for (uint32_t r = 0; r < region; r++) cdf[r] = (total += 1.0 / (r + 1));
+        uniform_real_distribution<double> uniform(0.0, total);
+        for (int i = 0; i < N; i++) {
+            uint32_t page = lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+            if (page >= region) page = region - 1;
+            addresses[i] = page * pageBytes + rng() % pageBytes;
+        }
+    } else if (strcmp(kind, "phases") == 0) {
+        uint32_t workingSet = max(K / 2, 1);
+        int phaseLength = max(N / 8, 1);
+        for (int i = 0; i < N; i++) {
+            uint32_t base = (uint32_t)(i / phaseLength) * workingSet * 4;
+            addresses[i] = (base + rng() % workingSet) * pageBytes + rng() % pageBytes;
+        }
+    } else if (strcmp(kind, "loop") == 0) {
+        uint32_t loopPages = 2 * (uint32_t)max(K, 1);
+        for (int i = 0; i < N; i++) addresses[i] = (i % loopPages) * pageBytes + rng() % pageBytes;
+    } else if (strcmp(kind, "drift") == 0) {
+        makeSyntheticTrace(addresses, N, P, 4 * max(K, 1), seed);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Write a generated workload as a one-case text trace: ./a.out --gen KIND N [S P K [SEED]]
+int writeGeneratedTrace(int argc, char* argv[]) {
+    const char* kind = argv[2];
+    int N = atoi(argv[3]);
+    int S = argc > 4 ? atoi(argv[4]) : 4096;
+    int P = argc > 5 ? atoi(argv[5]) : 4;
+    int K = argc > 6 ? atoi(argv[6]) : 64;
+    unsigned int seed = argc > 7 ? atoi(argv[7]) : 1;
+
+    vector<uint32_t> addresses;
+    if (!generateTrace(kind, N, P, K, seed, addresses)) {
+        cerr << "Unknown trace kind: " << kind << endl;
+        return 1;
+    }
+    string text = "1\n" + to_string(S) + " " + to_string(P) + " " + to_string(K) + " " + to_string(N) + "\n";
+    char line[16];
+    for (int i = 0; i < N; i++) {
+        snprintf(line, sizeof(line), "%x\n", addresses[i]);
+        text += line;
+    }
+    cout << text;
+    return 0;
+}
+
+// Benchmark suite: every policy over every synthetic workload at a few TLB
+// sizes, as CSV rows of trace,K,policy,hits,hit_ratio,maccess_per_s.
+// Throughput is for the page kernel alone on an already translated trace.
+void benchPolicies(int N) {
+    int P = 4;
+    int sizes[] = {64, 1024};
+    vector<uint32_t> addresses;
+    vector<int> pages;
+
+    cout << "trace,K,policy,hits,hit_ratio,maccess_per_s" << endl;
+    for (int t = 0; t < NUM_TRACE_KINDS; t++) {
+        for (int K : sizes) {
+            generateTrace(traceKinds[t], N, P, K, 1, addresses);
+            translatePages(P, N, addresses.data(), pages);
+            for (int p = 0; p < NUM_POLICIES; p++) {
+                auto t0 = chrono::steady_clock::now();
+                int hits = runPolicy(p, K, N, pages.data());
+                auto t1 = chrono::steady_clock::now();
+                double rate = N / chrono::duration<double, micro>(t1 - t0).count();
+                cout << traceKinds[t] << "," << K << "," << policyNames[p] << "," << hits << ","
+                     << (double)hits / N << "," << rate << endl;
+            }
+        }
+    }
+}
+
+// Read-only view of a whole input: mmapped when it is a regular file,
+// otherwise (pipes, terminals) slurped into a private buffer
+class MappedInput {
+private:
+    const char* data;
+    size_t length;
+    bool mapped;
+    vector<char> buffer;
+
+public:
+    MappedInput() : data(nullptr), length(0), mapped(false) {}
+
+    // Map the file behind fd, falling back to reading it when mmap is not possible
+    bool open(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, st.st_size, MADV_SEQUENTIAL);
+                data = (const char*)p;
+                length = st.st_size;
+                mapped = true;
+                return true;
+            }
+        }
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        data = buffer.data();
+        length = buffer.size();
+        return n == 0;
+    }
+
+    // Destructor to unmap the file
+    ~MappedInput() {
+        if (mapped) munmap((void*)data, length);
+    }
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+};
+
+// Hex digit value of every byte, or -1 for non-hex bytes
+static signed char hexValue[256];
+
+static void initHexTable() {
+    memset(hexValue, -1, sizeof(hexValue));
+    for (int c = '0'; c <= '9'; c++) hexValue[c] = c - '0';
+    for (int c = 'a'; c <= 'f'; c++) hexValue[c] = c - 'a' + 10;
+    for (int c = 'A'; c <= 'F'; c++) hexValue[c] = c - 'A' + 10;
+}
+
+// Tokenizer over a MappedInput for the "T, S P K N, N hex addresses" trace format
+class TraceReader {
+private:
+    const char* cur;
+    const char* end;
+
+    void skipSpace() {
+        while (cur < end && (unsigned char)*cur <= ' ') cur++;
+    }
+
+public:
+    TraceReader(const MappedInput& in) : cur(in.begin()), end(in.end()) {
+        if (hexValue[0] == 0) initHexTable();
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return cur >= end;
+    }
+
+    // Parse a decimal integer
+    long long readDecimal() {
+        skipSpace();
+        bool negative = false;
+        if (cur < end && (*cur == '-' || *cur == '+')) negative = (*cur++ == '-');
+        long long value = 0;
+        while (cur < end && (unsigned)(*cur - '0') < 10) {
+            value = value * 10 + (*cur++ - '0');
+        }
+        return negative ? -value : value;
+    }
+
+    // Parse a hexadecimal address with an optional 0x prefix into value.
+    // Returns false if there is no hex digit, e.g. at the end of the input.
+    // With SSE2, 16 bytes are classified and converted to nibbles at once and
+    // only the final combine is scalar.
+    bool readHex(unsigned long long& value) {
+        skipSpace();
+        if (end - cur >= 2 && cur[0] == '0' && (cur[1] == 'x' || cur[1] == 'X')) cur += 2;
+        const char* start = cur;
+        value = 0;
+#ifdef __SSE2__
+        while (end - cur >= 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)cur);
+            // Fold lower case onto upper case, then test the two digit ranges
+            __m128i upper = _mm_and_si128(bytes, _mm_set1_epi8((char)0xDF));
+            __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                            _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+            __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(upper, _mm_set1_epi8('A' - 1)),
+                                            _mm_cmplt_epi8(upper, _mm_set1_epi8('F' + 1)));
+            __m128i nibbles = _mm_or_si128(
+                _mm_and_si128(isDigit, _mm_sub_epi8(bytes, _mm_set1_epi8('0'))),
+                _mm_and_si128(isAlpha, _mm_sub_epi8(upper, _mm_set1_epi8('A' - 10))));
+            unsigned int hexMask = _mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha));
+            int len = __builtin_ctz(~hexMask); // hexMask < 0x10000, so ~hexMask != 0
+
+            alignas(16) unsigned char digits[16];
+            _mm_store_si128((__m128i*)digits, nibbles);
+            for (int j = 0; j < len; j++) value = (value << 4) | digits[j];
+            cur += len;
+            if (len < 16) return cur > start;
+        }
+#endif
+        while (cur < end) {
+            int d = hexValue[(unsigned char)*cur];
+            if (d < 0) break;
+            value = (value << 4) | d;
+            cur++;
+        }
+        return cur > start;
+    }
+};
+
+// Map a raw binary trace file (little-endian u32 or u64 addresses, no header)
+// Returns the number of addresses, or -1 if the file cannot be mapped.
+long long mapBinaryTrace(const char* path, int width, MappedInput& file) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    bool ok = file.open(fd);
+    close(fd);
+    if (!ok) {
+        perror(path);
+        return -1;
+    }
+    return file.size() / width;
+}
+
+// Whether the host stores integers little-endian, so binary traces can be used in place
+static bool hostIsLittleEndian() {
+    unsigned int one = 1;
+    unsigned char first;
+    memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+// Run FIFO/LIFO/LRU/Optimal on a mapped binary trace of Addr-sized addresses.
+// On little-endian hosts the policies read the addresses straight out of the mapping.
+template <typename Addr>
+void runBinaryTraceAs(const MappedInput& file, int P, int K) {
+    int N = (int)(file.size() / sizeof(Addr)); // runBinaryTrace rejects more than INT_MAX
+    const unsigned char* raw = (const unsigned char*)file.begin();
+    vector<Addr> copy;
+    const Addr* addresses;
+    if (hostIsLittleEndian() && ((uintptr_t)raw % alignof(Addr)) == 0) {
+        addresses = (const Addr*)raw; // Zero-copy
+    } else {
+        // Decode byte by byte
+        copy.resize(N);
+        for (int i = 0; i < N; i++) {
+            Addr value = 0;
+            for (int b = sizeof(Addr) - 1; b >= 0; b--) value = (value << 8) | raw[(size_t)i * sizeof(Addr) + b];
+            copy[i] = value;
+        }
+        addresses = copy.data();
+    }
+
+    PolicyHits hits = runAllPolicies(P, K, N, addresses);
+    cout << hits.fifo << " " << hits.lifo << " " << hits.lru << " " << hits.opt << endl;
+}
+
+// Run FIFO/LIFO/LRU/Optimal on a binary trace: ./a.out --binary32|--binary64 FILE S P K
+int runBinaryTrace(const char* mode, const char* path, int S, int P, int K) {
+    int width = strcmp(mode, "--binary64") == 0 ? 8 : 4;
+    MappedInput file;
+    long long count = mapBinaryTrace(path, width, file);
+    if (count < 0) return 1;
+    if (count > INT_MAX) {
+        cerr << path << ": " << count << " addresses, at most " << INT_MAX << " are supported" << endl;
+        return 1;
+    }
+    if (width == 8) runBinaryTraceAs<uint64_t>(file, P, K);
+    else runBinaryTraceAs<uint32_t>(file, P, K);
+    return 0;
+}
+
 // int main() {
 //     int T;
 //     cin >> T; // Number of test cases
@@ -321,40 +1942,334 @@ int Optimal(int S, int P, int K, int N, unsigned int addresses[])
 // Add debug statements to track execution
 //cout << "Processing test case " << T << endl;
 
-int main() {
-    int T;
-    cin >> T; // Number of test cases
-    //cout << "Number of test cases: " << T << endl;
+// Simulation options parsed from the command line
+struct SimOptions {
+    int mrcMaxK = 0;
+    int ways = 0;
+    bool hierarchy = false;
+    TLBLevelConfig l1 = {64, 4, POLICY_LRU}, l2 = {1536, 12, POLICY_LRU};
+    int l1Cycles = 1, l2Cycles = 8, missCycles = 30;
+    bool mixedPages = false;
+    vector<PageSizeRegion> regions;
+    vector<int> splitEntries;
+    int jobs = 0;              // Worker threads for batch mode, 0 = sequential
+    bool extended = false;     // Print every policy in policyNames, not just the four
+    bool pageWalk = false;     // Report translation cycles instead of hits
+    PageWalkConfig walk;
+    bool wideAddresses = false; // Read text traces as 64-bit addresses
+    double shardsRate = 0;     // SHARDS sampling rate for LRU, 0 = exact
+    bool shardsVerify = false; // Also run exact LRU and report the sampling error
+};
 
-    while (T--) 
-    {
-        int S, P, K, N;
-        cin >> S >> P >> K >> N; // Read input
-        //cout << "S: " << S << ", P: " << P << ", K: " << K << ", N: " << N << endl;
+// One test case of a text trace
+template <typename Addr>
+struct TestCase {
+    int S, P, K, N;
+    vector<Addr> addresses;
+};
+
+// Read the next test case: "S P K N" followed by N hex addresses.
+// Reports and returns false if the input ends or has a non-address before N addresses.
+template <typename Addr>
+bool readTestCase(TraceReader& reader, int testCase, TestCase<Addr>& tc) {
+    tc.S = reader.readDecimal();
+    tc.P = reader.readDecimal();
+    tc.K = reader.readDecimal();
+    tc.N = reader.readDecimal();
+    tc.addresses.resize(tc.N > 0 ? tc.N : 0);
+    for (int i = 0; i < tc.N; i++) {
+        unsigned long long address;
+        if (!reader.readHex(address)) {
+            cerr << "Test case " << testCase << ": expected " << tc.N << " addresses, found " << i << endl;
+            return false;
+        }
+        tc.addresses[i] = (Addr)address;
+    }
+    return true;
+}
 
-        // Ensure that N is valid before allocating addresses array
+// Simulate one test case in the selected mode and write its output lines
+template <typename Addr>
+void runTestCase(int testCase, const TestCase<Addr>& tc, const SimOptions& options,
+                 bool parallelPolicies, ostream& out) {
+    const Addr* addresses = tc.addresses.data();
 
-        unsigned int* addresses = new unsigned int[N]; // Dynamic allocation
+    if (options.shardsRate > 0) {
+        printSampledLRU(out, testCase, tc.P, tc.K, tc.N, addresses, options.mrcMaxK,
+                        options.shardsRate, options.shardsVerify);
+        return;
+    }
 
-        //changes here
-        for (int i = 0; i < N; i++) {
-            string hexInput;
-            cin >> hexInput;
-            addresses [i] = stoul(hexInput, nullptr, 16);
-            //cout << "Address " << i << ": " << addresses[i] << endl;
+    if (options.mrcMaxK > 0) {
+        printMissRatioCurve(out, testCase, tc.P, tc.N, addresses, options.mrcMaxK);
+        return;
+    }
+
+    if (options.hierarchy) {
+        HierarchyStats stats = runHierarchy(tc.P, tc.N, addresses, options.l1, options.l2,
+                                            options.l1Cycles, options.l2Cycles, options.missCycles);
+        out << stats.l1Hits << " " << stats.l2Hits << " " << stats.misses << " "
+            << stats.avgCycles << endl;
+        return;
+    }
+
+    if (options.pageWalk) {
+        vector<long long> cycles = runPageWalks(tc.S, tc.P, tc.K, tc.N, addresses, options.walk);
+        int shown = options.extended ? NUM_POLICIES : 4;
+        for (int p = 0; p < shown; p++) out << (p ? " " : "") << cycles[p];
+        out << endl;
+        return;
+    }
+
+    if (options.extended) {
+        vector<typename AddressTraits<Addr>::Page> pages;
+        translatePages(tc.P, tc.N, addresses, pages);
+        for (int p = 0; p < NUM_POLICIES; p++) {
+            out << (p ? " " : "") << runPolicy(p, tc.K, tc.N, pages.data());
         }
+        out << endl;
+        return;
+    }
 
-        // Run the different TLB replacement algorithms
-        int fifoHits = FIFO(S, P, K, N, addresses);
-        int lifoHits = LIFO(S, P, K, N, addresses);
-        int lruHits = LRU(S, P, K, N, addresses);
-        int optHits = Optimal(S, P, K, N, addresses);
+    // Run the different TLB replacement algorithms
+    PolicyHits hits;
+    if (options.mixedPages) {
+        hits = runMixedPageSizes(tc.P, tc.K, tc.N, addresses, options.regions, options.splitEntries);
+    } else if (options.ways > 0) {
+        if (tc.K > options.ways && tc.K % options.ways != 0) {
+            cerr << "Test case " << testCase << ": K=" << tc.K << " is not a multiple of --assoc "
+                 << options.ways << endl;
+            return;
+        }
+        hits = runSetAssociative(tc.P, tc.K, options.ways, tc.N, addresses);
+    } else {
+        hits = runAllPolicies(tc.P, tc.K, tc.N, addresses, parallelPolicies);
+    }
+
+    // Output results
+    out <<hits.fifo<<" "<<hits.lifo<<" "<<hits.lru<<" "<<hits.opt <<endl;
+}
 
-        // Output results
-        cout <<fifoHits<<" "<<lifoHits<<" "<<lruHits<<" "<<optHits <<endl;
+// Run tasks 0..count-1 on a pool of work-stealing threads. Each worker owns a
+// deque seeded with a contiguous block of tasks and takes work from its front;
+// an idle worker steals from the back of another worker's deque, so one huge
+// task only holds up the worker running it. Tasks never spawn tasks, so a
+// worker that finds every deque empty is done.
+void runWorkStealing(int count, int workers, const function<void(int)>& task) {
+    struct WorkerQueue {
+        mutex lock;
+        deque<int> tasks;
+    };
+    if (workers > count) workers = count;
+    if (workers < 1) workers = 1;
 
-        //delete[] addresses; // Free the allocated memory
+    vector<unique_ptr<WorkerQueue>> queues;
+    for (int w = 0; w < workers; w++) {
+        queues.emplace_back(new WorkerQueue);
+        for (int t = (long long)count * w / workers; t < (long long)count * (w + 1) / workers; t++) {
+            queues[w]->tasks.push_back(t);
+        }
     }
 
-    return 0;
-}
\ No newline at end of file
+    auto worker = [&](int id) {
+        while (true) {
+            int next = -1;
+            {
+                lock_guard<mutex> guard(queues[id]->lock);
+                if (!queues[id]->tasks.empty()) {
+                    next = queues[id]->tasks.front();
+                    queues[id]->tasks.pop_front();
+                }
+            }
+            for (int v = 1; next == -1 && v < workers; v++) {
+                WorkerQueue& victim = *queues[(id + v) % workers];
+                lock_guard<mutex> guard(victim.lock);
+                if (!victim.tasks.empty()) {
+                    next = victim.tasks.back();
+                    victim.tasks.pop_back();
+                }
+            }
+            if (next == -1) return;
+            task(next);
+        }
+    };
+
+    vector<thread> threads;
+    for (int w = 1; w < workers; w++) threads.emplace_back(worker, w);
+    worker(0);
+    for (thread& t : threads) t.join();
+}
+
+// Simulate the T test cases of a text trace with Addr-sized addresses, either
+// streaming one case at a time or, in batch mode, on the work-stealing pool.
+// Returns false if a test case was cut short; the cases before it still run.
+template <typename Addr>
+bool runTextTrace(TraceReader& reader, int T, const SimOptions& options, bool batch) {
+    if (batch) {
+        // Read every test case, simulate them on the pool, then print in input order
+        vector<TestCase<Addr>> cases;
+        bool complete = true;
+        while ((int)cases.size() < T && !reader.atEnd()) {
+            cases.emplace_back();
+            if (!readTestCase(reader, (int)cases.size(), cases.back())) {
+                cases.pop_back();
+                complete = false;
+                break;
+            }
+        }
+        vector<string> outputs(cases.size());
+        runWorkStealing(cases.size(), options.jobs, [&](int c) {
+            ostringstream out;
+            runTestCase(c + 1, cases[c], options, false, out);
+            outputs[c] = out.str();
+        });
+        for (const string& text : outputs) cout << text;
+        return complete;
+    }
+    TestCase<Addr> tc; // Address buffer is reused across test cases
+    for (int testCase = 1; testCase <= T && !reader.atEnd(); testCase++) {
+        if (!readTestCase(reader, testCase, tc)) return false;
+        runTestCase(testCase, tc, options, true, cout);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Benchmark mode: ./a.out --bench-optimal [N]
+    if (argc > 1 && strcmp(argv[1], "--bench-optimal") == 0) {
+        benchOptimal(argc > 2 ? atoi(argv[2]) : 200000);
+        return 0;
+    }
+
+    // Benchmark mode: ./a.out --bench-lru [N]
+    if (argc > 1 && strcmp(argv[1], "--bench-lru") == 0) {
+        benchLRU(argc > 2 ? atoi(argv[2]) : 2000000);
+        return 0;
+    }
+
+    // Benchmark suite: ./a.out --bench [N]
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        benchPolicies(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+
+    // Trace generator: ./a.out --gen sequential|strided|zipf|phases|loop|drift N [S P K [SEED]]
+    if (argc > 3 && strcmp(argv[1], "--gen") == 0) {
+        return writeGeneratedTrace(argc, argv);
+    }
+
+    // Binary trace mode: ./a.out --binary32|--binary64 FILE S P K
+    if (argc > 5 && (strcmp(argv[1], "--binary32") == 0 || strcmp(argv[1], "--binary64") == 0)) {
+        return runBinaryTrace(argv[1], argv[2], atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+    }
+
+    // Text traces come from stdin, or from a file named on the command line.
+    // --mrc MAXK prints the LRU miss-ratio curve for K = 1..MAXK instead of hit counts.
+    // --assoc WAYS models each K-entry TLB as WAYS-way set-associative
+    // (K must be a multiple of WAYS).
+    // --l1 E,W,POLICY --l2 E,W,POLICY [--cycles L1,L2,MISS] runs a two-level
+    // hierarchy instead and prints "l1_hits l2_hits misses avg_cycles".
+    // --page-map FILE mixes page sizes per address range (see loadPageSizeMap);
+    // --split E0,E1,... gives each size class, smallest first, its own TLB.
+    // --jobs J runs the test cases on J threads (0 = one per core); output
+    // order is unchanged.
+    // --addr64 reads text-trace addresses as 64-bit instead of truncating them.
+    // --extended prints the hits of every policy in policyNames
+    // (fifo lifo lru optimal clock lfu arc random).
+    // --walk L|B1,...,BL charges each TLB miss a page-table walk (L levels, or
+    // explicit bits per level) and prints total translation cycles per policy;
+    // --pwc E sizes the page-walk cache, --walk-cycles TLB,PWC,MEM sets costs.
+    // --shards RATE estimates LRU hits (or, with --mrc, the curve) from a
+    // spatially hashed sample of pages; --verify adds the error versus exact.
+    const char* path = nullptr;
+    SimOptions options;
+    bool batch = false;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--mrc") == 0 && a + 1 < argc) {
+            options.mrcMaxK = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--assoc") == 0 && a + 1 < argc) {
+            options.ways = atoi(argv[++a]);
+        } else if ((strcmp(argv[a], "--l1") == 0 || strcmp(argv[a], "--l2") == 0) && a + 1 < argc) {
+            TLBLevelConfig& level = argv[a][3] == '1' ? options.l1 : options.l2;
+            if (!parseLevelConfig(argv[++a], level)) {
+                cerr << "Expected ENTRIES,WAYS,fifo|lifo|lru with ENTRIES a multiple of WAYS after "
+                     << argv[a - 1] << endl;
+                return 1;
+            }
+            options.hierarchy = true;
+        } else if (strcmp(argv[a], "--cycles") == 0 && a + 1 < argc) {
+            if (sscanf(argv[++a], "%d,%d,%d", &options.l1Cycles, &options.l2Cycles,
+                       &options.missCycles) != 3) {
+                cerr << "Expected L1,L2,MISS after --cycles" << endl;
+                return 1;
+            }
+            options.hierarchy = true;
+        } else if (strcmp(argv[a], "--page-map") == 0 && a + 1 < argc) {
+            if (!loadPageSizeMap(argv[++a], options.regions)) return 1;
+            options.mixedPages = true;
+        } else if (strcmp(argv[a], "--split") == 0 && a + 1 < argc) {
+            for (char* entry = strtok(argv[++a], ","); entry; entry = strtok(nullptr, ",")) {
+                options.splitEntries.push_back(atoi(entry));
+            }
+            options.mixedPages = true;
+        } else if (strcmp(argv[a], "--jobs") == 0 && a + 1 < argc) {
+            options.jobs = atoi(argv[++a]);
+            if (options.jobs <= 0) options.jobs = max(1u, thread::hardware_concurrency());
+            batch = true;
+        } else if (strcmp(argv[a], "--walk") == 0 && a + 1 < argc) {
+            if (!parseWalkShape(argv[++a], options.walk.levelBits)) {
+                cerr << "Expected a level count or comma-separated bits after --walk" << endl;
+                return 1;
+            }
+            options.pageWalk = true;
+        } else if (strcmp(argv[a], "--pwc") == 0 && a + 1 < argc) {
+            options.walk.pwcEntries = atoi(argv[++a]);
+            options.pageWalk = true;
+        } else if (strcmp(argv[a], "--walk-cycles") == 0 && a + 1 < argc) {
+            if (sscanf(argv[++a], "%d,%d,%d", &options.walk.tlbCycles, &options.walk.pwcCycles,
+                       &options.walk.memCycles) != 3) {
+                cerr << "Expected TLB,PWC,MEM after --walk-cycles" << endl;
+                return 1;
+            }
+            options.pageWalk = true;
+        } else if (strcmp(argv[a], "--shards") == 0 && a + 1 < argc) {
+            options.shardsRate = atof(argv[++a]);
+            if (options.shardsRate <= 0 || options.shardsRate > 1) {
+                cerr << "Expected a sampling rate in (0, 1] after --shards" << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[a], "--verify") == 0) {
+            options.shardsVerify = true;
+        } else if (strcmp(argv[a], "--addr64") == 0) {
+            options.wideAddresses = true;
+        } else if (strcmp(argv[a], "--extended") == 0) {
+            options.extended = true;
+        } else {
+            path = argv[a];
+        }
+    }
+
+    int fd = 0;
+    if (path) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            perror(path);
+            return 1;
+        }
+    }
+    MappedInput input;
+    if (!input.open(fd)) {
+        perror("read");
+        return 1;
+    }
+    TraceReader reader(input);
+
+    int T = reader.readDecimal(); // Number of test cases
+    if (options.mrcMaxK > 0) cout << "case,K,hits,miss_ratio" << endl;
+
+    bool complete = options.wideAddresses ? runTextTrace<uint64_t>(reader, T, options, batch)
+                                          : runTextTrace<uint32_t>(reader, T, options, batch);
+
+    if (fd != 0) close(fd);
+    return complete ? 0 : 1;
+}
@@ -1,25 +1,174 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // For mremap; define it before any include to let my_realloc remap
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <pthread.h>
+#include <errno.h>
 
 #define HEADER_SIZE sizeof(struct header)
+#define FOOTER_SIZE sizeof(struct footer)
+#define REGION_HEADER_SIZE ((sizeof(struct region) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1))
+// Bytes of a region besides the user data of one block spanning it: region header,
+// prologue footer, the block's header and footer, epilogue header
+#define REGION_OVERHEAD (REGION_HEADER_SIZE + FOOTER_SIZE + HEADER_SIZE + FOOTER_SIZE + HEADER_SIZE)
+#define SIZE_CLASS_SPLITS 4  // Free lists per power of two of the block size
+#define NUM_SIZE_CLASSES (64 * SIZE_CLASS_SPLITS)
+#define ALIGNMENT 16         // Alignment of every user pointer
+#define SLAB_SIZE (64 * 1024)  // Bytes mmapped at a time for small objects
+#define NUM_SLAB_CLASSES 10
+#define TCACHE_BATCH 16        // Objects moved between a thread cache and the slabs at once
+#define TCACHE_MAX 64          // Objects a thread caches per class before flushing a batch
+#define HEAP_CHUNK_MIN (64 * 1024)          // First region mapped for list blocks
+#define HEAP_CHUNK_MAX (16 * 1024 * 1024)   // Regions stop doubling at this size
 
 typedef struct header *header_ptr;
 size_t page_size = 0;  // Store system page size for alignment
-// Base pointer for the memory pool
+// Base pointer for the memory pool: the first mmapped region of list blocks
 void *base = NULL;
+// Last region of the list rooted at base, so the heap can grow without a walk
+struct region *last_region = NULL;
+
+// Kind of allocation a user pointer belongs to
+enum block_kind {
+    BLOCK_HEAP = 0x48454150,  // Block in a region of the list rooted at base
+    BLOCK_SLAB = 0x534c4142,  // Small object carved out of a slab
+    BLOCK_LARGE = 0x4c415247  // Large allocation with a mapping of its own
+};
+
+// Tag stored in the 16 bytes just before every user pointer, so my_free can
+// tell a slab object from a list block
+struct block_tag {
+    void *owner;           // Slab of a small object, region of an epilogue, NULL for list blocks
+    size_t kind;           // enum block_kind
+};
 
 // Memory block header structure
 struct header {
     bool is_free;       // True if memory block is free, false otherwise
-    size_t size;        // Size of memory block (excluding the header)
-    header_ptr next;    // Points to the next memory block
-    header_ptr prev;    // Points to the previous memory block
+    bool is_fresh;      // Free block whose user data is still zero from mmap, except its free-list links
+    size_t size;        // Size of memory block (excluding the header and footer)
+    struct block_tag tag;  // Must stay last: it sits right before the user data
+};
+
+// Boundary tag closing every block, so the block before a header is found in O(1)
+struct footer {
+    size_t size;        // Copy of the header's size
+    bool is_free;       // Copy of the header's is_free
+};
+
+// One mmapped area of list blocks: region header, a prologue footer, the
+// blocks, then an epilogue header; prologue and epilogue are never free
+struct region {
+    struct region *next;   // Next region in mapping order
+    struct region *prev;   // Previous region in mapping order
+    size_t size;           // Bytes mapped, this header included
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(struct header) % ALIGNMENT == 0, "header must keep user data aligned");
+static_assert(sizeof(struct footer) % ALIGNMENT == 0, "footer must keep the next header aligned");
+#else
+_Static_assert(sizeof(struct header) % ALIGNMENT == 0, "header must keep user data aligned");
+_Static_assert(sizeof(struct footer) % ALIGNMENT == 0, "footer must keep the next header aligned");
+#endif
+
+// Slab of equally sized small objects; each object is a block_tag followed by its user data
+struct slab {
+    struct slab *next;     // Next slab of the class with free objects
+    struct slab *prev;     // Previous slab of the class with free objects
+    int size_class;        // Index into slab_object_sizes
+    size_t capacity;       // Objects that fit in the slab
+    size_t in_use;         // Objects currently allocated
+    char *unused;          // Start of the never-allocated part of the slab
+    void *free_objects;    // Freed objects, linked through their first word
+};
+
+// User sizes of the small-object classes
+const size_t slab_object_sizes[NUM_SLAB_CLASSES] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+// Requests up to this size use the slabs; 0 sends everything to the block list
+size_t small_object_max = 512;
+// Requests of at least this size bypass the block list and get a mapping of their own
+size_t mmap_threshold = 128 * 1024;
+// Slabs of each class that still have a free object
+struct slab *partial_slabs[NUM_SLAB_CLASSES];
+
+// Per-thread cache of free small objects, linked through their first word
+struct thread_cache {
+    void *objects[NUM_SLAB_CLASSES];
+    int count[NUM_SLAB_CLASSES];
+    bool registered;       // Exit destructor installed for this thread
+};
+__thread struct thread_cache tcache;
+pthread_key_t tcache_key;
+pthread_once_t tcache_key_once = PTHREAD_ONCE_INIT;
+
+// Central arena lock: guards the block list, the free lists, the slabs and the counters below
+pthread_mutex_t arena_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Memory accounting for my_malloc_print_overhead and my_malloc_stats (objects in thread caches count as in use)
+size_t heap_bytes_mapped = 0;   // Bytes mmapped for list blocks
+size_t heap_bytes_in_use = 0;   // User bytes of allocated list blocks
+size_t slab_bytes_mapped = 0;   // Bytes mmapped for slabs
+size_t slab_bytes_in_use = 0;   // User bytes of allocated small objects
+size_t heap_bytes_retained = 0; // Bytes of regions with no block in use
+size_t large_bytes_mapped = 0;  // Bytes mmapped for large allocations
+size_t large_bytes_in_use = 0;  // User bytes of large allocations
+size_t mmap_calls = 0;          // mmap system calls made for regions, slabs and large allocations
+size_t munmap_calls = 0;        // munmap system calls made for regions, slabs and large allocations
+size_t heap_free_blocks = 0;    // Blocks on the free lists
+size_t heap_free_bytes = 0;     // User bytes of blocks on the free lists
+size_t block_searches = 0;      // Free-block searches made by block_malloc
+size_t block_scan_steps = 0;    // Blocks looked at by those searches
+
+// Heap growth and release
+size_t heap_chunk_size = HEAP_CHUNK_MIN;  // Smallest next region; doubles with each region mapped
+size_t trim_threshold = 4 * 1024 * 1024;  // Bytes of entirely free regions kept mapped for reuse
+
+// Snapshot of the allocator's counters, filled in by my_malloc_stats
+struct malloc_stats {
+    size_t bytes_mapped;        // Bytes mmapped for slabs, regions and large allocations
+    size_t bytes_in_use;        // User bytes handed out (small objects at their class size)
+    size_t free_blocks;         // Free list blocks
+    size_t free_bytes;          // User bytes in free list blocks
+    size_t largest_free_block;  // User bytes of the largest free list block
+    double fragmentation;       // 1 - largest_free_block / free_bytes (0 when nothing is free)
+    size_t mmap_calls;          // mmap calls made so far
+    size_t munmap_calls;        // munmap calls made so far
+    size_t searches;            // Free-block searches made by block_malloc
+    size_t scan_steps;          // Blocks looked at by those searches
+    double average_scan_length; // scan_steps / searches
+};
+
+// Links of the explicit free list, stored in the user area of a free block
+struct free_links {
+    header_ptr next_free;  // Next free block in the same size class
+    header_ptr prev_free;  // Previous free block in the same size class
 };
 
+#define MIN_BLOCK_SIZE sizeof(struct free_links)  // Smallest user area a free block can have
+
+// Placement policy used by my_malloc
+enum placement_policy {
+    FIRST_FIT,       // Walk every block of every region from base (original behaviour)
+    SEGREGATED_FIT,  // Search the size-class free lists
+    NEXT_FIT,        // Walk the blocks from where the previous search stopped
+    BEST_FIT         // Smallest free block that fits, found through the size classes
+};
+enum placement_policy placement = SEGREGATED_FIT;
+
+// Heads of the size-class free lists; bit c % 64 of free_list_bitmap[c / 64] is set when list c is non-empty
+header_ptr free_lists[NUM_SIZE_CLASSES];
+uint64_t free_list_bitmap[NUM_SIZE_CLASSES / 64];
+
+// Block where the next next-fit search starts; NULL starts it at base
+header_ptr next_fit_rover = NULL;
+
 // HELPER FUNCTIONS
 
 // Internal function to initialize page_size
@@ -34,123 +183,987 @@ size_t round_to_page_size(size_t size) {
     return (size + page_size - 1) & ~(page_size - 1);
 }
 
-// Find a suitable free block using the first-fit policy
-header_ptr find_suitable_block(header_ptr *last, size_t size) {
-    header_ptr search_ptr = (header_ptr)base;
-    while (search_ptr && !(search_ptr->is_free && search_ptr->size >= size)) {
-        *last = search_ptr;
-        search_ptr = search_ptr->next;
+// Round size up to a multiple of ALIGNMENT
+static inline size_t round_to_alignment(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+// Get the header of the block containing the pointer
+header_ptr get_block_start(void *ptr) {
+    return (header_ptr)((char *)ptr - HEADER_SIZE);
+}
+
+// Calculate the pointer to user data from the header pointer
+static inline void* get_user_data(header_ptr head) {
+    return (void*)((char *)head + HEADER_SIZE);  // Move past the header
+}
+
+// Free-list links of a free block
+static inline struct free_links *get_free_links(header_ptr block) {
+    return (struct free_links *)get_user_data(block);
+}
+
+// Size class of a block: floor(log2(size)), refined by the next two bits of the size
+// so each power of two is split into SIZE_CLASS_SPLITS lists of equal width
+static inline int size_class_of(size_t size) {
+    int log2 = 63 - __builtin_clzll((unsigned long long)size);
+    if (log2 < 2) {
+        return log2 * SIZE_CLASS_SPLITS;
     }
-    return search_ptr;
+    return log2 * SIZE_CLASS_SPLITS + (int)((size >> (log2 - 2)) & (SIZE_CLASS_SPLITS - 1));
 }
 
-// Split the block if it’s larger than needed and ensures alignment
-void split_block(header_ptr block, size_t size) {
-    size = round_to_page_size(size + HEADER_SIZE);
-    if (block->size - size >= HEADER_SIZE) {  // Ensure there's space for another block
-        header_ptr new_block = (header_ptr)((char *)block + size); // New block starts after user data
-        new_block->size = block->size - size - HEADER_SIZE;
-        block->size = size - HEADER_SIZE;
+// Smallest non-empty size class from size_class upwards, or -1 if there is none
+static inline int next_nonempty_class(int size_class) {
+    for (int word = size_class / 64; word < NUM_SIZE_CLASSES / 64; word++) {
+        uint64_t bits = free_list_bitmap[word];
+        if (word == size_class / 64) {
+            bits &= ~0ULL << (size_class % 64);
+        }
+        if (bits) {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+
+// Largest non-empty size class, or -1 if every free list is empty
+static inline int largest_nonempty_class() {
+    for (int word = NUM_SIZE_CLASSES / 64 - 1; word >= 0; word--) {
+        if (free_list_bitmap[word]) {
+            return word * 64 + 63 - __builtin_clzll(free_list_bitmap[word]);
+        }
+    }
+    return -1;
+}
 
-        // Update pointers
-        new_block->next = block->next;
-        block->next = new_block;
-        new_block->prev = block;
+// Footer of a block, found just before the next block's header
+static inline struct footer *get_footer(header_ptr block) {
+    return (struct footer *)((char *)get_user_data(block) + block->size);
+}
+
+// Physically next block; the epilogue of a region has size 0
+static inline header_ptr next_block(header_ptr block) {
+    return (header_ptr)((char *)get_footer(block) + FOOTER_SIZE);
+}
+
+// Footer of the physically previous block; the prologue of a region has size 0
+static inline struct footer *prev_footer(header_ptr block) {
+    return (struct footer *)((char *)block - FOOTER_SIZE);
+}
 
-        if (new_block->next) {
-            new_block->next->prev = new_block;
+// Physically previous block, given its footer
+static inline header_ptr prev_block(header_ptr block) {
+    return (header_ptr)((char *)block - FOOTER_SIZE - prev_footer(block)->size - HEADER_SIZE);
+}
+
+// Write the header and footer of a list block
+static inline void set_block(header_ptr block, size_t size, bool is_free) {
+    block->is_free = is_free;
+    block->size = size;
+    block->tag.owner = NULL;
+    block->tag.kind = BLOCK_HEAP;
+    struct footer *footer = get_footer(block);
+    footer->size = size;
+    footer->is_free = is_free;
+}
+
+// Flip the free flag in both boundary tags of a block
+static inline void mark_block(header_ptr block, bool is_free) {
+    block->is_free = is_free;
+    get_footer(block)->is_free = is_free;
+}
+
+// First block of a region, right after the prologue footer
+static inline header_ptr first_block(struct region *region) {
+    return (header_ptr)((char *)region + REGION_HEADER_SIZE + FOOTER_SIZE);
+}
+
+// Push a free block onto the front of its size-class list
+void insert_free_block(header_ptr block) {
+    int size_class = size_class_of(block->size);
+    struct free_links *links = get_free_links(block);
+    links->prev_free = NULL;
+    links->next_free = free_lists[size_class];
+    if (links->next_free) {
+        get_free_links(links->next_free)->prev_free = block;
+    }
+    free_lists[size_class] = block;
+    free_list_bitmap[size_class / 64] |= 1ULL << (size_class % 64);
+    heap_free_blocks++;
+    heap_free_bytes += block->size;
+}
+
+// Unlink a free block from its size-class list
+void remove_free_block(header_ptr block) {
+    int size_class = size_class_of(block->size);
+    struct free_links *links = get_free_links(block);
+    if (links->prev_free) {
+        get_free_links(links->prev_free)->next_free = links->next_free;
+    } else {
+        free_lists[size_class] = links->next_free;
+        if (!free_lists[size_class]) {
+            free_list_bitmap[size_class / 64] &= ~(1ULL << (size_class % 64));
         }
-        
-        new_block->is_free = true;  // Mark the new block as free
     }
+    if (links->next_free) {
+        get_free_links(links->next_free)->prev_free = links->prev_free;
+    }
+    heap_free_blocks--;
+    heap_free_bytes -= block->size;
 }
 
-// Extend the heap using mmap to request new memory
-header_ptr extend_heap(header_ptr last, size_t size) {
-    size_t total_size = round_to_page_size(HEADER_SIZE + size); // Ensure allocation is page-aligned
-    header_ptr new_ptr = (header_ptr)mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
-    
-    if (new_ptr == MAP_FAILED) {  // Check if mmap succeeded
+// Find a suitable free block using the first-fit policy: every block of every region, oldest region first
+header_ptr find_suitable_block(size_t size) {
+    size_t steps = 0;
+    header_ptr found = NULL;
+    for (struct region *region = (struct region *)base; region && !found; region = region->next) {
+        for (header_ptr search_ptr = first_block(region); search_ptr->size; search_ptr = next_block(search_ptr)) {
+            steps++;
+            if (search_ptr->is_free && search_ptr->size >= size) {
+                found = search_ptr;
+                break;
+            }
+        }
+    }
+    block_searches++;
+    block_scan_steps += steps;
+    return found;
+}
+
+// Find a free block from the size-class lists: first fit within the request's own
+// class, otherwise the head of the smallest non-empty larger class, which always fits
+header_ptr find_segregated_block(size_t size) {
+    int size_class = size_class_of(size);
+    block_searches++;
+    for (header_ptr block = free_lists[size_class]; block; block = get_free_links(block)->next_free) {
+        block_scan_steps++;
+        if (block->size >= size) {
+            return block;
+        }
+    }
+    int larger = next_nonempty_class(size_class + 1);
+    block_scan_steps += larger >= 0;
+    return larger >= 0 ? free_lists[larger] : NULL;
+}
+
+// Find a free block using the next-fit policy: walk the blocks like first fit, but start
+// where the previous search stopped and wrap around to base once, so the small blocks
+// left near base are not scanned again on every request
+header_ptr find_next_fit_block(size_t size) {
+    block_searches++;
+    if (!base) {
         return NULL;
     }
+    header_ptr start = next_fit_rover ? next_fit_rover : first_block((struct region *)base);
+    header_ptr block = start;
+    do {
+        if (block->size == 0) {
+            // Epilogue: continue with the next region, or wrap around to base
+            struct region *next = ((struct region *)block->tag.owner)->next;
+            block = first_block(next ? next : (struct region *)base);
+            continue;
+        }
+        block_scan_steps++;
+        if (block->is_free && block->size >= size) {
+            next_fit_rover = block;
+            return block;
+        }
+        block = next_block(block);
+    } while (block != start);
+    return NULL;
+}
+
+// Find the smallest free block that fits. Size classes never overlap, so the best fit
+// lies in the first class holding any fitting block: the request's own class, or else
+// the smallest non-empty larger one, where only that class's list is scanned
+header_ptr find_best_fit_block(size_t size) {
+    block_searches++;
+    for (int size_class = size_class_of(size); size_class >= 0; size_class = next_nonempty_class(size_class + 1)) {
+        header_ptr best = NULL;
+        for (header_ptr block = free_lists[size_class]; block; block = get_free_links(block)->next_free) {
+            block_scan_steps++;
+            if (block->size >= size && (!best || block->size < best->size)) {
+                best = block;
+                if (best->size == size) {
+                    break;  // Exact fit
+                }
+            }
+        }
+        if (best) {
+            return best;
+        }
+    }
+    return NULL;
+}
+
+// Split the block if it’s larger than needed and ensures alignment
+void split_block(header_ptr block, size_t size) {
+    size = round_to_alignment(size);  // User bytes kept by block
+    if (block->size >= size + FOOTER_SIZE + HEADER_SIZE + MIN_BLOCK_SIZE) {  // Ensure there's space for another block
+        size_t rest = block->size - size - FOOTER_SIZE - HEADER_SIZE;
+        set_block(block, size, block->is_free);
+        header_ptr new_block = next_block(block);  // New block starts after the footer
+        set_block(new_block, rest, true);  // Mark the new block as free
+        new_block->is_fresh = block->is_fresh;  // Its user data was untouched user data of block
+        insert_free_block(new_block);
+    }
+}
 
-    new_ptr->size = total_size - HEADER_SIZE;  // Store size of the user-accessible block
-    new_ptr->is_free = false;  // Mark as used
-    new_ptr->next = NULL;      // No next block yet
-    new_ptr->prev = last;      // Set previous block
+// Extend the heap using mmap: a new region holding one block of at least size bytes.
+// Regions grow geometrically, so a run of misses costs O(log n) mmap calls.
+header_ptr extend_heap(size_t size) {
+    size_t block_size = round_to_alignment(size);
+    size_t total_size = round_to_page_size(REGION_OVERHEAD + block_size); // Ensure allocation is page-aligned
+    if (total_size < heap_chunk_size) {
+        total_size = heap_chunk_size;
+    }
+    struct region *region = (struct region *)mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+
+    if (region == MAP_FAILED) {  // Check if mmap succeeded
+        return NULL;
+    }
+    mmap_calls++;
+    if (total_size == heap_chunk_size && heap_chunk_size < HEAP_CHUNK_MAX) {
+        heap_chunk_size *= 2;
+    }
 
-    if (last) {
-        last->next = new_ptr;  // Link with previous block
+    // Append the region so first fit still searches the oldest memory first
+    region->size = total_size;
+    region->next = NULL;
+    region->prev = last_region;
+    if (last_region) {
+        last_region->next = region;
+    } else {
+        base = region;
     }
+    last_region = region;
+    heap_bytes_mapped += total_size;
+
+    // Prologue footer and epilogue header are permanently allocated, so merges stop at the region edges
+    struct footer *prologue = (struct footer *)((char *)region + REGION_HEADER_SIZE);
+    prologue->size = 0;
+    prologue->is_free = false;
+    header_ptr new_ptr = first_block(region);
+    set_block(new_ptr, total_size - REGION_OVERHEAD, false);  // Store size of the user-accessible block
+    new_ptr->is_fresh = true;  // Anonymous mappings arrive zeroed
+    header_ptr epilogue = next_block(new_ptr);
+    epilogue->size = 0;
+    epilogue->is_free = false;
+    epilogue->tag.owner = region;  // Lets next fit step from one region to the next
+    epilogue->tag.kind = BLOCK_HEAP;
 
     return new_ptr;
 }
 
-// Merge current block with the next free block if possible
+// Merge current block with the next block if it is free; that block leaves its free list
 header_ptr merge_free_blocks(header_ptr current_block) {
-    if (current_block->next && current_block->next->is_free) {
-        current_block->size += HEADER_SIZE + current_block->next->size;  // Increase size
-        current_block->next = current_block->next->next;  // Update next pointer
-
-        if (current_block->next) {
-            current_block->next->prev = current_block;  // Update previous pointer
+    header_ptr next = next_block(current_block);
+    if (next->is_free) {
+        remove_free_block(next);
+        if (next == next_fit_rover) {
+            next_fit_rover = current_block;  // The rover must not point inside a block
         }
+        set_block(current_block, current_block->size + FOOTER_SIZE + HEADER_SIZE + next->size, current_block->is_free);
+        current_block->is_fresh = false;  // The old boundary tags now sit inside the user data
     }
     return current_block;
 }
 
-// Get the header of the block containing the pointer
-header_ptr get_block_start(void *ptr) {
-    return (header_ptr)((char *)ptr - HEADER_SIZE);
+// Merge a block that is not on a free list with its physical neighbours in O(1)
+header_ptr coalesce(header_ptr head) {
+    merge_free_blocks(head);
+    if (prev_footer(head)->is_free) {
+        header_ptr prev = prev_block(head);
+        remove_free_block(prev);
+        set_block(prev, prev->size + FOOTER_SIZE + HEADER_SIZE + head->size, true);
+        prev->is_fresh = false;
+        if (head == next_fit_rover) {
+            next_fit_rover = prev;
+        }
+        head = prev;
+    }
+    return head;
 }
 
-// Calculate the pointer to user data from the header pointer
-static inline void* get_user_data(header_ptr head) {
-    return (void*)((char *)head + HEADER_SIZE);  // Move past the header
+// Region a block belongs to if the block spans the whole region, otherwise NULL
+static inline struct region *whole_region(header_ptr block) {
+    if (prev_footer(block)->size != 0 || next_block(block)->size != 0) {
+        return NULL;
+    }
+    return (struct region *)((char *)block - FOOTER_SIZE - REGION_HEADER_SIZE);
 }
 
-// PART-02 of ASSIGNMENT : my_malloc, my_free, my_calloc
+// Unlink a region from the region list and return it to the kernel
+void release_region(struct region *region) {
+    if ((char *)next_fit_rover > (char *)region && (char *)next_fit_rover < (char *)region + region->size) {
+        next_fit_rover = NULL;
+    }
+    if (region->prev) {
+        region->prev->next = region->next;
+    } else {
+        base = region->next;
+    }
+    if (region->next) {
+        region->next->prev = region->prev;
+    } else {
+        last_region = region->prev;
+    }
+    heap_bytes_mapped -= region->size;
+    munmap_calls++;
+    munmap(region, region->size);
+}
 
-// Function to allocate memory
-void* my_malloc(size_t size) {
-    initialize_page_size(); // Initialize page size if required
-    header_ptr last = NULL;
-    header_ptr first_fit;
+// Unmap regions with nothing in use, oldest first, until at most keep bytes of them remain
+void trim_regions(size_t keep) {
+    struct region *region = (struct region *)base;
+    while (region && heap_bytes_retained > keep) {
+        struct region *next = region->next;
+        header_ptr block = first_block(region);
+        if (block->is_free && whole_region(block)) {
+            remove_free_block(block);
+            heap_bytes_retained -= region->size;
+            release_region(region);
+        }
+        region = next;
+    }
+}
+
+// Give the page-aligned interior of a free block back to the kernel, keeping the
+// mapping; the partial pages at either end are zeroed so the block is fresh again
+size_t advise_free_block(header_ptr block) {
+    char *start = (char *)get_user_data(block);
+    char *end = start + block->size;
+    char *first_page = (char *)round_to_page_size((uintptr_t)start + MIN_BLOCK_SIZE);  // Keep the free-list links
+    char *last_page = (char *)((uintptr_t)end & ~(page_size - 1));
+    if (last_page <= first_page) {
+        return 0;
+    }
+    if (madvise(first_page, last_page - first_page, MADV_DONTNEED) != 0) {
+        return 0;
+    }
+    memset(start + MIN_BLOCK_SIZE, 0, first_page - start - MIN_BLOCK_SIZE);
+    memset(last_page, 0, end - last_page);
+    block->is_fresh = true;
+    return last_page - first_page;
+}
+
+// Index of the smallest slab class holding size bytes
+static inline int slab_class_of(size_t size) {
+    int size_class = 0;
+    while (slab_object_sizes[size_class] < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+// Bytes between consecutive objects of a slab class
+static inline size_t slab_stride(int size_class) {
+    return sizeof(struct block_tag) + slab_object_sizes[size_class];
+}
+
+// Unlink a slab from its class's list of slabs with free objects
+void remove_partial_slab(struct slab *slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        partial_slabs[slab->size_class] = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+}
+
+// Push a slab onto the front of its class's list of slabs with free objects
+void insert_partial_slab(struct slab *slab) {
+    slab->prev = NULL;
+    slab->next = partial_slabs[slab->size_class];
+    if (slab->next) {
+        slab->next->prev = slab;
+    }
+    partial_slabs[slab->size_class] = slab;
+}
+
+// Map a new empty slab for a class and make it the first partial slab
+struct slab *new_slab(int size_class) {
+    struct slab *slab = (struct slab *)mmap(NULL, SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (slab == MAP_FAILED) {
+        return NULL;
+    }
+    mmap_calls++;
+    size_t first = round_to_alignment(sizeof(struct slab));
+    slab->size_class = size_class;
+    slab->capacity = (SLAB_SIZE - first) / slab_stride(size_class);
+    slab->in_use = 0;
+    slab->unused = (char *)slab + first;
+    slab->free_objects = NULL;
+    insert_partial_slab(slab);
+    slab_bytes_mapped += SLAB_SIZE;
+    return slab;
+}
+
+// Allocate a small object from the first slab of its class with room
+void *slab_alloc(int size_class) {
+    struct slab *slab = partial_slabs[size_class];
+    if (!slab && !(slab = new_slab(size_class))) {
+        return NULL;
+    }
+
+    void *object;
+    if (slab->free_objects) {
+        object = slab->free_objects;
+        slab->free_objects = *(void **)object;
+    } else {
+        // Carve the next object; its tag is written once and survives frees
+        struct block_tag *tag = (struct block_tag *)slab->unused;
+        tag->owner = slab;
+        tag->kind = BLOCK_SLAB;
+        object = tag + 1;
+        slab->unused += slab_stride(size_class);
+    }
+
+    if (++slab->in_use == slab->capacity) {
+        remove_partial_slab(slab);  // Full slabs leave the list until an object is freed
+    }
+    slab_bytes_in_use += slab_object_sizes[size_class];
+    return object;
+}
+
+// Return a small object to its slab; an empty slab is unmapped unless it is the class's only one
+void slab_free(void *object, struct slab *slab) {
+    if (slab->in_use == slab->capacity) {
+        insert_partial_slab(slab);
+    }
+    *(void **)object = slab->free_objects;
+    slab->free_objects = object;
+    slab->in_use--;
+    slab_bytes_in_use -= slab_object_sizes[slab->size_class];
+
+    if (slab->in_use == 0 && (slab->prev || slab->next)) {
+        remove_partial_slab(slab);
+        munmap(slab, SLAB_SIZE);
+        munmap_calls++;
+        slab_bytes_mapped -= SLAB_SIZE;
+    }
+}
+
+// Print mapped versus in-use bytes for the slabs, the block list and large allocations
+void my_malloc_print_overhead(FILE *out) {
+    pthread_mutex_lock(&arena_lock);
+    size_t mapped = heap_bytes_mapped + slab_bytes_mapped + large_bytes_mapped;
+    size_t in_use = heap_bytes_in_use + slab_bytes_in_use + large_bytes_in_use;
+    fprintf(out, "slabs:  %zu bytes mapped, %zu in use\n", slab_bytes_mapped, slab_bytes_in_use);
+    fprintf(out, "blocks: %zu bytes mapped, %zu in use\n", heap_bytes_mapped, heap_bytes_in_use);
+    fprintf(out, "large:  %zu bytes mapped, %zu in use\n", large_bytes_mapped, large_bytes_in_use);
+    fprintf(out, "overhead: %.2fx mapped per byte in use\n", in_use ? (double)mapped / in_use : 0.0);
+    pthread_mutex_unlock(&arena_lock);
+}
+
+// Return up to count cached objects of a class to their slabs; caller holds arena_lock
+void flush_thread_cache(struct thread_cache *cache, int size_class, int count) {
+    while (count-- > 0 && cache->objects[size_class]) {
+        void *object = cache->objects[size_class];
+        cache->objects[size_class] = *(void **)object;
+        cache->count[size_class]--;
+        slab_free(object, (struct slab *)((struct block_tag *)object - 1)->owner);
+    }
+}
+
+// Thread-exit destructor: hand every cached object back to the slabs
+void release_thread_cache(void *value) {
+    struct thread_cache *cache = (struct thread_cache *)value;
+    pthread_mutex_lock(&arena_lock);
+    for (int size_class = 0; size_class < NUM_SLAB_CLASSES; size_class++) {
+        flush_thread_cache(cache, size_class, cache->count[size_class]);
+    }
+    pthread_mutex_unlock(&arena_lock);
+}
+
+static void create_thread_cache_key() {
+    pthread_key_create(&tcache_key, release_thread_cache);
+}
+
+// Make sure the calling thread's cache is flushed when the thread exits
+static inline void register_thread_cache(struct thread_cache *cache) {
+    if (!cache->registered) {
+        pthread_once(&tcache_key_once, create_thread_cache_key);
+        pthread_setspecific(tcache_key, cache);
+        cache->registered = true;
+    }
+}
 
-    // If base is not NULL, find a suitable block
-    if (base) {
-        last = (header_ptr)base;
-        first_fit = find_suitable_block(&last, size);  // Only use the requested size
-        if (first_fit) {
-            // If block is larger than needed, split it
-            split_block(first_fit, size);  // Use requested size
-            first_fit->is_free = false;  // Mark block as used
-        } else {
-            // Extend heap if no suitable block was found
-            first_fit = extend_heap(last, size);
-            if (!first_fit) {
-                perror("malloc");
-                return NULL;
+// Allocate a small object from the thread cache, refilling it from the slabs in batches
+void *tcache_alloc(int size_class) {
+    struct thread_cache *cache = &tcache;
+    if (!cache->objects[size_class]) {
+        register_thread_cache(cache);
+        pthread_mutex_lock(&arena_lock);
+        for (int i = 0; i < TCACHE_BATCH; i++) {
+            void *object = slab_alloc(size_class);
+            if (!object) {
+                break;
             }
+            *(void **)object = cache->objects[size_class];
+            cache->objects[size_class] = object;
+            cache->count[size_class]++;
+        }
+        pthread_mutex_unlock(&arena_lock);
+        if (!cache->objects[size_class]) {
+            return NULL;
+        }
+    }
+    void *object = cache->objects[size_class];
+    cache->objects[size_class] = *(void **)object;
+    cache->count[size_class]--;
+    return object;
+}
+
+// Free a small object into the thread cache, flushing a batch to the slabs when it is full
+void tcache_free(void *object, struct slab *slab) {
+    struct thread_cache *cache = &tcache;
+    int size_class = slab->size_class;
+    register_thread_cache(cache);
+    if (cache->count[size_class] >= TCACHE_MAX) {
+        pthread_mutex_lock(&arena_lock);
+        flush_thread_cache(cache, size_class, TCACHE_BATCH);
+        pthread_mutex_unlock(&arena_lock);
+    }
+    *(void **)object = cache->objects[size_class];
+    cache->objects[size_class] = object;
+    cache->count[size_class]++;
+}
+
+// Allocate a block from the regions rooted at base; caller holds arena_lock.
+// If fresh is not NULL it reports whether the user data is still zero past MIN_BLOCK_SIZE.
+void *block_malloc(size_t size, bool *fresh) {
+    header_ptr first_fit;
+
+    if (size < MIN_BLOCK_SIZE) {
+        size = MIN_BLOCK_SIZE;  // Room for the free-list links once the block is freed
+    }
+
+    switch (placement) {
+    case FIRST_FIT:
+        first_fit = find_suitable_block(size);  // Only use the requested size
+        break;
+    case NEXT_FIT:
+        first_fit = find_next_fit_block(size);
+        break;
+    case BEST_FIT:
+        first_fit = find_best_fit_block(size);
+        break;
+    default:
+        first_fit = find_segregated_block(size);
+        break;
+    }
+    if (first_fit) {
+        remove_free_block(first_fit);
+        struct region *region = whole_region(first_fit);
+        if (region) {
+            heap_bytes_retained -= region->size;  // The region is in use again
         }
+        mark_block(first_fit, false);  // Mark block as used
     } else {
-        // Initialize the linked list
-        first_fit = extend_heap(NULL, size);  // First allocation
+        // Extend heap if no suitable block was found
+        first_fit = extend_heap(size);
         if (!first_fit) {
             perror("malloc");
             return NULL;
         }
-        base = first_fit;  // Set base pointer
     }
+    // If block is larger than needed, split it
+    split_block(first_fit, size);  // Use requested size
+    if (fresh) {
+        *fresh = first_fit->is_fresh;
+    }
+    first_fit->is_fresh = false;  // The caller is about to write to it
+    heap_bytes_in_use += first_fit->size;
     return get_user_data(first_fit);  // Return pointer to user data
 }
 
+// Release a list block, merging it with its neighbours; caller holds arena_lock
+void block_free(header_ptr head) {
+    mark_block(head, true);  // Mark as free
+    heap_bytes_in_use -= head->size;
+
+    // Attempt to merge with previous and next blocks
+    head = coalesce(head);
+    insert_free_block(head);
+
+    // Regions with nothing in use stay mapped for reuse until they add up to more than
+    // trim_threshold, then the oldest go back to the system until half of that remains
+    struct region *region = whole_region(head);
+    if (region) {
+        heap_bytes_retained += region->size;
+        if (heap_bytes_retained > trim_threshold) {
+            trim_regions(trim_threshold / 2);
+        }
+    }
+}
+
+// Shrink a block to size bytes in place, merging the cut-off tail with a free next block
+void trim_block(header_ptr block, size_t size) {
+    size_t old_size = block->size;
+    split_block(block, size);
+    if (block->size != old_size) {
+        header_ptr rest = next_block(block);
+        remove_free_block(rest);
+        insert_free_block(merge_free_blocks(rest));
+    }
+}
+
+// Grow a block that spans a whole region by remapping the region, which may move it
+header_ptr remap_region(header_ptr block, size_t size) {
+#ifdef MREMAP_MAYMOVE
+    struct region *region = whole_region(block);
+    size_t total_size = round_to_page_size(REGION_OVERHEAD + size);
+    if (next_fit_rover == block) {
+        next_fit_rover = NULL;  // The block may move with its region
+    }
+    struct region *moved = (struct region *)mremap(region, region->size, total_size, MREMAP_MAYMOVE);
+    if (moved == MAP_FAILED) {
+        return NULL;
+    }
+
+    // The region may have moved: repoint its neighbours in the region list
+    if (moved->prev) {
+        moved->prev->next = moved;
+    } else {
+        base = moved;
+    }
+    if (moved->next) {
+        moved->next->prev = moved;
+    } else {
+        last_region = moved;
+    }
+    heap_bytes_mapped += total_size - moved->size;
+    moved->size = total_size;
+
+    block = first_block(moved);
+    set_block(block, total_size - REGION_OVERHEAD, false);
+    block->is_fresh = false;
+    header_ptr epilogue = next_block(block);
+    epilogue->size = 0;
+    epilogue->is_free = false;
+    epilogue->tag.owner = moved;
+    epilogue->tag.kind = BLOCK_HEAP;
+    return block;
+#else
+    return NULL;  // No mremap on this system: the caller copies instead
+#endif
+}
+
+// Resize a list block: in place when it shrinks or the next block is free,
+// by mremap when it fills its region, otherwise by copying; caller holds arena_lock.
+// Returns NULL without touching the contents when a copy would reach mmap_threshold.
+void *block_realloc(header_ptr block, size_t size) {
+    bool large = size >= mmap_threshold;
+    if (size < MIN_BLOCK_SIZE) {
+        size = MIN_BLOCK_SIZE;
+    }
+    size = round_to_alignment(size);
+    size_t old_size = block->size;
+    size_t counted = old_size;  // Bytes of block included in heap_bytes_in_use
+
+    if (size > block->size) {
+        merge_free_blocks(block);  // Absorb a free next block, even one too small on its own
+        // Count the absorbed bytes as in use, so the copy path's block_free and the
+        // caller's free after a NULL return subtract what was added
+        heap_bytes_in_use += block->size - counted;
+        counted = block->size;
+        if (block->size < size && whole_region(block)) {
+            header_ptr moved = remap_region(block, size);
+            if (moved) {
+                block = moved;
+            }
+        }
+    }
+
+    if (block->size >= size) {
+        trim_block(block, size);
+        heap_bytes_in_use += block->size - counted;
+        return get_user_data(block);
+    }
+
+    if (large) {
+        return NULL;  // The caller moves it to a mapping of its own
+    }
+    void *new_ptr = block_malloc(size, NULL);
+    if (new_ptr) {
+        memcpy(new_ptr, get_user_data(block), old_size);
+        block_free(block);
+    }
+    return new_ptr;
+}
+
+// Allocate an aligned block from the block list: over-allocate by the alignment, then
+// give the bytes before the aligned address back as a free block and trim the tail;
+// caller holds arena_lock
+void *block_aligned_malloc(size_t alignment, size_t size) {
+    if (size < MIN_BLOCK_SIZE) {
+        size = MIN_BLOCK_SIZE;
+    }
+    size = round_to_alignment(size);
+    // Room for a leading free block of at least MIN_BLOCK_SIZE whatever the offset
+    char *ptr = (char *)block_malloc(size + HEADER_SIZE + FOOTER_SIZE + MIN_BLOCK_SIZE + alignment - ALIGNMENT, NULL);
+    if (!ptr) {
+        return NULL;
+    }
+    header_ptr block = get_block_start(ptr);
+    size_t old_size = block->size;
+
+    if ((uintptr_t)ptr & (alignment - 1)) {
+        char *aligned = (char *)(((uintptr_t)ptr + HEADER_SIZE + FOOTER_SIZE + MIN_BLOCK_SIZE + alignment - 1)
+                                 & ~(uintptr_t)(alignment - 1));
+        header_ptr gap = block;
+        block = get_block_start(aligned);
+        size_t gap_size = (char *)block - FOOTER_SIZE - ptr;
+        set_block(block, old_size - gap_size - FOOTER_SIZE - HEADER_SIZE, false);
+        block->is_fresh = false;
+        set_block(gap, gap_size, true);  // The block before gap is in use, so there is nothing to merge
+        gap->is_fresh = false;
+        insert_free_block(gap);
+    }
+    trim_block(block, size);
+    heap_bytes_in_use += block->size - old_size;
+    return get_user_data(block);
+}
+
+// Allocate size bytes in a mapping of their own, behind a header tagged BLOCK_LARGE
+void *large_malloc(size_t size) {
+    size_t total_size = round_to_page_size(HEADER_SIZE + size);
+    header_ptr head = (header_ptr)mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (head == MAP_FAILED) {
+        return NULL;
+    }
+    head->is_free = false;
+    head->is_fresh = false;
+    head->size = total_size - HEADER_SIZE;
+    head->tag.owner = NULL;
+    head->tag.kind = BLOCK_LARGE;
+
+    pthread_mutex_lock(&arena_lock);
+    large_bytes_mapped += total_size;
+    large_bytes_in_use += head->size;
+    mmap_calls++;
+    pthread_mutex_unlock(&arena_lock);
+    return get_user_data(head);
+}
+
+// Allocate size bytes at a multiple of alignment in a mapping of their own: map enough
+// slack to reach the alignment, then unmap the whole pages on either side
+void *large_aligned_malloc(size_t alignment, size_t size) {
+    size_t slack_size = round_to_page_size(HEADER_SIZE + size + alignment);
+    char *mapping = (char *)mmap(NULL, slack_size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    char *ptr = (char *)(((uintptr_t)mapping + HEADER_SIZE + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    char *start = (char *)((uintptr_t)(ptr - HEADER_SIZE) & ~(page_size - 1));  // Page holding the header
+    char *end = (char *)round_to_page_size((uintptr_t)(ptr + size));
+    size_t trimmed = 0;
+    if (start > mapping) {
+        munmap(mapping, start - mapping);
+        trimmed++;
+    }
+    if (end < mapping + slack_size) {
+        munmap(end, mapping + slack_size - end);
+        trimmed++;
+    }
+
+    header_ptr head = get_block_start(ptr);
+    head->is_free = false;
+    head->is_fresh = false;
+    head->size = end - ptr;
+    head->tag.owner = NULL;
+    head->tag.kind = BLOCK_LARGE;
+
+    pthread_mutex_lock(&arena_lock);
+    large_bytes_mapped += end - start;
+    large_bytes_in_use += head->size;
+    mmap_calls++;
+    munmap_calls += trimmed;
+    pthread_mutex_unlock(&arena_lock);
+    return ptr;
+}
+
+// Unmap a large allocation; an aligned one starts at the page holding its header
+void large_free(header_ptr head) {
+    char *start = (char *)((uintptr_t)head & ~(page_size - 1));
+    size_t total_size = (char *)get_user_data(head) + head->size - start;
+    pthread_mutex_lock(&arena_lock);
+    large_bytes_mapped -= total_size;
+    large_bytes_in_use -= head->size;
+    munmap_calls++;
+    pthread_mutex_unlock(&arena_lock);
+    munmap(start, total_size);
+}
+
+// Resize a large allocation with mremap, which moves pages instead of copying them
+void *large_realloc(header_ptr head, size_t size) {
+    size_t old_size = head->size;
+    size_t total_size = round_to_page_size(HEADER_SIZE + size);
+    if (total_size == HEADER_SIZE + old_size) {
+        return get_user_data(head);
+    }
+#ifdef MREMAP_MAYMOVE
+    if (((uintptr_t)head & (page_size - 1)) == 0) {  // Aligned allocations have their header inside a page
+        header_ptr moved = (header_ptr)mremap(head, HEADER_SIZE + old_size, total_size, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            return NULL;
+        }
+        moved->size = total_size - HEADER_SIZE;
+        pthread_mutex_lock(&arena_lock);
+        large_bytes_mapped = large_bytes_mapped - old_size + moved->size;
+        large_bytes_in_use = large_bytes_in_use - old_size + moved->size;
+        pthread_mutex_unlock(&arena_lock);
+        return get_user_data(moved);
+    }
+#endif
+    void *new_ptr = large_malloc(size);
+    if (new_ptr) {
+        memcpy(new_ptr, get_user_data(head), old_size < size ? old_size : size);
+        large_free(head);
+    }
+    return new_ptr;
+}
+
+// Set the request size from which my_malloc maps each allocation on its own
+void my_malloc_set_mmap_threshold(size_t bytes) {
+    mmap_threshold = bytes;
+}
+
+// Collect the allocator's counters; free-block figures cover the block list only.
+// Costs one walk of the largest non-empty size class, nothing on the allocation path.
+struct malloc_stats my_malloc_stats() {
+    struct malloc_stats stats;
+    pthread_mutex_lock(&arena_lock);
+    stats.bytes_mapped = heap_bytes_mapped + slab_bytes_mapped + large_bytes_mapped;
+    stats.bytes_in_use = heap_bytes_in_use + slab_bytes_in_use + large_bytes_in_use;
+    stats.free_blocks = heap_free_blocks;
+    stats.free_bytes = heap_free_bytes;
+    stats.largest_free_block = 0;
+    int size_class = largest_nonempty_class();
+    if (size_class >= 0) {
+        for (header_ptr block = free_lists[size_class]; block; block = get_free_links(block)->next_free) {
+            if (block->size > stats.largest_free_block) {
+                stats.largest_free_block = block->size;
+            }
+        }
+    }
+    stats.fragmentation = heap_free_bytes ? 1.0 - (double)stats.largest_free_block / heap_free_bytes : 0.0;
+    stats.mmap_calls = mmap_calls;
+    stats.munmap_calls = munmap_calls;
+    stats.searches = block_searches;
+    stats.scan_steps = block_scan_steps;
+    stats.average_scan_length = block_searches ? (double)block_scan_steps / block_searches : 0.0;
+    pthread_mutex_unlock(&arena_lock);
+    return stats;
+}
+
+// Print my_malloc_stats in a readable form
+void my_malloc_print_stats(FILE *out) {
+    struct malloc_stats stats = my_malloc_stats();
+    fprintf(out, "bytes mapped:       %zu\n", stats.bytes_mapped);
+    fprintf(out, "bytes in use:       %zu\n", stats.bytes_in_use);
+    fprintf(out, "free blocks:        %zu (%zu bytes)\n", stats.free_blocks, stats.free_bytes);
+    fprintf(out, "largest free block: %zu\n", stats.largest_free_block);
+    fprintf(out, "fragmentation:      %.3f\n", stats.fragmentation);
+    fprintf(out, "mmap/munmap calls:  %zu/%zu\n", stats.mmap_calls, stats.munmap_calls);
+    fprintf(out, "average scan:       %.2f blocks over %zu searches\n", stats.average_scan_length, stats.searches);
+}
+
+// Select the placement policy for subsequent my_malloc calls
+void my_malloc_set_policy(enum placement_policy policy) {
+    pthread_mutex_lock(&arena_lock);
+    placement = policy;
+    pthread_mutex_unlock(&arena_lock);
+}
+
+// Return all unused memory to the system now: unmap every region with nothing in
+// use and drop the pages inside the other free blocks. Returns the bytes released.
+size_t my_malloc_trim() {
+    initialize_page_size();
+    pthread_mutex_lock(&arena_lock);
+    size_t released = heap_bytes_mapped;
+    trim_regions(0);
+    released -= heap_bytes_mapped;
+    for (int size_class = 0; size_class < NUM_SIZE_CLASSES; size_class++) {
+        for (header_ptr block = free_lists[size_class]; block; block = get_free_links(block)->next_free) {
+            if (!block->is_fresh) {
+                released += advise_free_block(block);
+            }
+        }
+    }
+    pthread_mutex_unlock(&arena_lock);
+    return released;
+}
+
+// Set how many bytes of entirely free regions my_free keeps mapped for reuse
+void my_malloc_set_trim_threshold(size_t bytes) {
+    pthread_mutex_lock(&arena_lock);
+    trim_threshold = bytes;
+    if (heap_bytes_retained > trim_threshold) {
+        trim_regions(trim_threshold / 2);
+    }
+    pthread_mutex_unlock(&arena_lock);
+}
+
+// PART-02 of ASSIGNMENT : my_malloc, my_free, my_calloc (plus my_realloc and my_aligned_alloc)
+// All of them are thread-safe: small objects go through the calling thread's
+// cache and everything else is serialised on arena_lock.
+
+// Function to allocate memory
+void* my_malloc(size_t size) {
+    initialize_page_size(); // Initialize page size if required
+
+    if (size <= small_object_max) {
+        void *object = tcache_alloc(slab_class_of(size > 0 ? size : 1));
+        if (!object) {
+            perror("malloc");
+        }
+        return object;
+    }
+    if (size >= mmap_threshold) {
+        void *ptr = large_malloc(size);
+        if (!ptr) {
+            perror("malloc");
+        }
+        return ptr;
+    }
+
+    pthread_mutex_lock(&arena_lock);
+    void *ptr = block_malloc(size, NULL);
+    pthread_mutex_unlock(&arena_lock);
+    return ptr;
+}
+
 // Function to allocate and initialize memory to zero
+// Memory straight from mmap is already zero, so fresh blocks and large
+// allocations only clear their first bytes
 void* my_calloc(size_t nelem, size_t size) {
+    initialize_page_size(); // Initialize page size if required
+    if (size && nelem > SIZE_MAX / size) {  // nelem * size would overflow
+        errno = ENOMEM;
+        perror("calloc");
+        errno = ENOMEM;  // perror's own output may have changed it
+        return NULL;
+    }
     size_t s = nelem * size;  // Calculate total size
-    void *new_block = my_malloc(s);  // Allocate memory
+    void *new_block;
+    bool fresh = false;
+    if (s <= small_object_max) {
+        new_block = my_malloc(s);  // Allocate memory
+    } else if (s >= mmap_threshold) {
+        new_block = my_malloc(s);
+        fresh = true;
+    } else {
+        pthread_mutex_lock(&arena_lock);
+        new_block = block_malloc(s, &fresh);
+        pthread_mutex_unlock(&arena_lock);
+    }
     if (new_block) {
-        memset(new_block, 0, s);  // Initialize allocated memory to zero
+        memset(new_block, 0, fresh && s > MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : s);  // Initialize allocated memory to zero
     } else {
         perror("calloc");
     }
@@ -163,26 +1176,107 @@ void my_free(void* ptr) {
     if (ptr == NULL) return;  // Safety check
 
     // We assume only the pointers allocated by malloc/calloc are freed
-    header_ptr head = get_block_start(ptr);  // Get block header
-    head->is_free = true;  // Mark as free
+    struct block_tag *tag = (struct block_tag *)ptr - 1;
+    if (tag->kind == BLOCK_SLAB) {
+        tcache_free(ptr, (struct slab *)tag->owner);
+        return;
+    }
+    if (tag->kind == BLOCK_LARGE) {
+        large_free(get_block_start(ptr));
+        return;
+    }
 
-    // Attempt to merge with previous and next blocks
-    if (head->prev && head->prev->is_free) {
-        head = merge_free_blocks(head->prev);
+    pthread_mutex_lock(&arena_lock);
+    block_free(get_block_start(ptr));
+    pthread_mutex_unlock(&arena_lock);
+}
+
+// Function to resize an allocation, keeping its contents up to the smaller size
+void* my_realloc(void* ptr, size_t size) {
+    if (ptr == NULL) return my_malloc(size);
+    if (size == 0) {
+        my_free(ptr);
+        return NULL;
     }
 
-    if (head->next) {
-        merge_free_blocks(head);  // Merge with the next block if possible
-    } else {
-        // Release memory back to the system if it's the last block
-        if (head->prev) {
-            head->prev->next = NULL;  // Update previous block's next pointer
-        } else {
-            base = NULL;  // Reset base if it's the last block
+    struct block_tag *tag = (struct block_tag *)ptr - 1;
+    if (tag->kind == BLOCK_SLAB) {
+        size_t object_size = slab_object_sizes[((struct slab *)tag->owner)->size_class];
+        if (size <= object_size) {
+            return ptr;  // Still fits in its slab slot
         }
+        void *new_ptr = my_malloc(size);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, object_size);
+            my_free(ptr);
+        }
+        return new_ptr;
+    }
 
-        // Release memory back to the system
-        munmap(head, (HEADER_SIZE + head->size));
+    if (tag->kind == BLOCK_LARGE) {
+        void *new_ptr = large_realloc(get_block_start(ptr), size);
+        if (!new_ptr) {
+            perror("realloc");
+        }
+        return new_ptr;
+    }
+
+    pthread_mutex_lock(&arena_lock);
+    size_t old_size = get_block_start(ptr)->size;
+    void *new_ptr = block_realloc(get_block_start(ptr), size);
+    pthread_mutex_unlock(&arena_lock);
+    if (!new_ptr && size >= mmap_threshold) {
+        // Outgrew the block list: move to a mapping of its own
+        new_ptr = large_malloc(size);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, old_size);
+            my_free(ptr);
+        }
+    }
+    if (!new_ptr) {
+        perror("realloc");
     }
+    return new_ptr;
 }
 
+// Function to allocate size bytes at an address that is a multiple of alignment,
+// which must be a power of two. Alignments up to ALIGNMENT are what my_malloc gives
+// anyway; larger ones over-allocate by the alignment and free the unused lead, so
+// the cost is at most one alignment of free space rather than a page per call.
+void* my_aligned_alloc(size_t alignment, size_t size) {
+    initialize_page_size(); // Initialize page size if required
+    if (alignment == 0 || (alignment & (alignment - 1))) {
+        errno = EINVAL;
+        perror("aligned_alloc");
+        errno = EINVAL;
+        return NULL;
+    }
+    if (alignment <= ALIGNMENT) {
+        return my_malloc(size);
+    }
+    if (size > SIZE_MAX - page_size - HEADER_SIZE - FOOTER_SIZE - MIN_BLOCK_SIZE - alignment) {
+        errno = ENOMEM;
+        perror("aligned_alloc");
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    if (size + HEADER_SIZE + FOOTER_SIZE + MIN_BLOCK_SIZE + alignment >= mmap_threshold) {
+        void *ptr = large_aligned_malloc(alignment, size);
+        if (!ptr) {
+            perror("aligned_alloc");
+        }
+        return ptr;
+    }
+
+    // Slab objects are only ALIGNMENT-aligned, so small requests use the block list too
+    pthread_mutex_lock(&arena_lock);
+    void *ptr = block_aligned_malloc(alignment, size);
+    pthread_mutex_unlock(&arena_lock);
+    return ptr;
+}
+
+// Traditional name for my_aligned_alloc
+void* my_memalign(size_t alignment, size_t size) {
+    return my_aligned_alloc(alignment, size);
+}
@@ -0,0 +1,571 @@
+#define _GNU_SOURCE  // mremap for my_realloc
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "2021MT10904mmu.h"
+
+// Allocation throughput benchmark for 2021MT10904mmu.h
+// Build: gcc -O2 -pthread -o mmu_bench mmu_bench.c
+// Usage: ./mmu_bench [OPS] [LIVE] [MAX_SIZE]
+// Runs the same random malloc/free sequence (LIVE slots, sizes 1..MAX_SIZE)
+// under each placement policy and prints the time per operation.
+//        ./mmu_bench small [COUNT] [SIZE]
+// Allocates COUNT objects of SIZE bytes through the slabs and through the
+// block list, and prints the memory overhead of each.
+//        ./mmu_bench threads [THREADS] [OPS] [MAX_SIZE]
+// Runs OPS mostly-small allocations per thread on 1, 2, 4, .. THREADS threads,
+// checking every block's contents before it is freed, and prints throughput.
+//        ./mmu_bench realloc [MAX_MB] [STEP_KB]
+// Grows one buffer by STEP_KB at a time up to MAX_MB, with my_realloc and
+// with malloc/memcpy/free, and prints the time and number of moves of each.
+//        ./mmu_bench calloc [COUNT] [KB]
+// Times COUNT my_calloc calls of KB kilobytes against my_malloc plus memset.
+//        ./mmu_bench tail [OPS] [SIZE]
+// Allocates and frees a SIZE-byte block OPS times and counts the mmap and
+// munmap calls this costs, then shows what my_malloc_trim gives back.
+//        ./mmu_bench large [OPS] [LIVE]
+// First-fit churn where one request in 16 is 1 MiB, with and without the
+// mmap threshold that gives large requests mappings of their own.
+//        ./mmu_bench aligned [COUNT] [SIZE]
+// Allocates COUNT blocks of SIZE bytes with my_aligned_alloc at 32, 64 and
+// 4096-byte alignment, checks the addresses and prints the memory overhead.
+//        ./mmu_bench record FILE [OPS] [LIVE] [MAX_SIZE]
+// Writes the default churn sequence to FILE as an allocation trace.
+//        ./mmu_bench trace FILE
+// Replays an allocation trace under each placement policy and prints the time
+// per operation, peak memory, fragmentation and search length of each.
+// Trace lines are "a ID SIZE" (malloc), "r ID SIZE" (realloc) and "f ID" (free);
+// IDs name live allocations and lines starting with # are ignored.
+
+// Small deterministic generator so every policy sees the same sequence
+static unsigned int bench_rand(unsigned long long *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned int)(*state >> 33);
+}
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Average blocks looked at per free-block search since the snapshot before
+static double scan_length_since(struct malloc_stats before) {
+    struct malloc_stats after = my_malloc_stats();
+    size_t searches = after.searches - before.searches;
+    return searches ? (double)(after.scan_steps - before.scan_steps) / searches : 0.0;
+}
+
+// Fill LIVE slots, then replace a random slot OPS times; returns seconds taken and
+// stores the list blocks' mapped bytes per byte in use at the end of the churn.
+// With large_every > 0, one request in large_every is 1 MiB instead.
+double run_churn(enum placement_policy policy, long ops, int live, size_t max_size, int large_every,
+                 double *overhead) {
+    void **slots = calloc(live, sizeof(void *));
+    my_malloc_set_policy(policy);
+    unsigned long long state = 1;
+
+    double start = now_seconds();
+    for (long i = 0; i < ops; i++) {
+        int slot = bench_rand(&state) % live;
+        if (slots[slot]) {
+            my_free(slots[slot]);
+        }
+        size_t size = 1 + bench_rand(&state) % max_size;
+        if (large_every > 0 && bench_rand(&state) % large_every == 0) {
+            size = 1 << 20;
+        }
+        slots[slot] = my_malloc(size);
+        if (!slots[slot]) {
+            fprintf(stderr, "allocation of %zu bytes failed\n", size);
+            exit(1);
+        }
+        memset(slots[slot], (int)i, size < 64 ? size : 64);  // Touch the block
+    }
+    *overhead = heap_bytes_in_use ? (double)heap_bytes_mapped / heap_bytes_in_use : 0.0;
+    for (int slot = 0; slot < live; slot++) {
+        my_free(slots[slot]);
+    }
+    double elapsed = now_seconds() - start;
+
+    free(slots);
+    return elapsed;
+}
+
+// Allocate count objects of size bytes, report the overhead, then free them
+void run_small(const char *name, size_t object_max, long count, size_t size) {
+    void **objects = calloc(count, sizeof(void *));
+    small_object_max = object_max;
+
+    double start = now_seconds();
+    for (long i = 0; i < count; i++) {
+        objects[i] = my_malloc(size);
+        if (!objects[i]) {
+            fprintf(stderr, "allocation of %zu bytes failed\n", size);
+            exit(1);
+        }
+        memset(objects[i], (int)i, size);
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%s: %.1f ns/alloc\n", name, elapsed * 1e9 / count);
+    my_malloc_print_overhead(stdout);
+    for (long i = 0; i < count; i++) {
+        my_free(objects[i]);
+    }
+    free(objects);
+}
+
+// Work and result of one stress thread
+struct stress_thread {
+    pthread_t thread;
+    int id;
+    long ops;
+    size_t max_size;
+    void **slots;          // Left allocated for main to free from another thread
+    size_t *sizes;
+    long corrupted;
+};
+
+#define STRESS_SLOTS 256
+
+// Churn a private set of slots; one allocation in eight is up to max_size, the rest small
+void *stress_worker(void *arg) {
+    struct stress_thread *t = (struct stress_thread *)arg;
+    unsigned long long state = t->id + 1;
+    for (long i = 0; i < t->ops; i++) {
+        int slot = bench_rand(&state) % STRESS_SLOTS;
+        unsigned char fill = (unsigned char)(t->id * 31 + slot);
+        if (t->slots[slot]) {
+            unsigned char *bytes = (unsigned char *)t->slots[slot];
+            for (size_t k = 0; k < t->sizes[slot]; k++) {
+                if (bytes[k] != fill) {
+                    t->corrupted++;
+                    break;
+                }
+            }
+            my_free(t->slots[slot]);
+        }
+        size_t size = bench_rand(&state) % 8 ? 1 + bench_rand(&state) % 256 : 1 + bench_rand(&state) % t->max_size;
+        t->slots[slot] = my_malloc(size);
+        t->sizes[slot] = size;
+        memset(t->slots[slot], fill, size);
+    }
+    return NULL;
+}
+
+// Run the stress workload on 1, 2, 4, .. max_threads threads
+int run_threads(int max_threads, long ops, size_t max_size) {
+    struct stress_thread *threads = calloc(max_threads, sizeof(struct stress_thread));
+    long corrupted = 0;
+    printf("%ld ops per thread, sizes 1..256 (1 in 8 up to %zu)\n", ops, max_size);
+    for (int count = 1;; count = count * 2 < max_threads ? count * 2 : max_threads) {
+        double start = now_seconds();
+        for (int i = 0; i < count; i++) {
+            threads[i].id = i;
+            threads[i].ops = ops;
+            threads[i].max_size = max_size;
+            threads[i].slots = calloc(STRESS_SLOTS, sizeof(void *));
+            threads[i].sizes = calloc(STRESS_SLOTS, sizeof(size_t));
+            threads[i].corrupted = 0;
+            pthread_create(&threads[i].thread, NULL, stress_worker, &threads[i]);
+        }
+        for (int i = 0; i < count; i++) {
+            pthread_join(threads[i].thread, NULL);
+        }
+        double elapsed = now_seconds() - start;
+
+        for (int i = 0; i < count; i++) {
+            for (int slot = 0; slot < STRESS_SLOTS; slot++) {
+                my_free(threads[i].slots[slot]);  // Cross-thread frees
+            }
+            corrupted += threads[i].corrupted;
+            free(threads[i].slots);
+            free(threads[i].sizes);
+        }
+        printf("%2d threads %8.3f s  %8.2f Mops/s\n", count, elapsed, count * ops / elapsed / 1e6);
+        if (count == max_threads) {
+            break;
+        }
+    }
+    free(threads);
+    if (corrupted) {
+        printf("%ld corrupted blocks\n", corrupted);
+    }
+    return corrupted ? 1 : 0;
+}
+
+// Grow a buffer step bytes at a time to max_bytes; copy selects malloc/memcpy/free over my_realloc
+void run_realloc(const char *name, bool copy, size_t max_bytes, size_t step) {
+    size_t size = step;
+    char *buffer = my_malloc(size);
+    memset(buffer, 1, size);
+    long moves = 0, resizes = 0;
+
+    double start = now_seconds();
+    for (; size + step <= max_bytes; size += step, resizes++) {
+        char *grown;
+        if (copy) {
+            grown = my_malloc(size + step);
+            memcpy(grown, buffer, size);
+            my_free(buffer);
+        } else {
+            grown = my_realloc(buffer, size + step);
+        }
+        if (!grown) {
+            fprintf(stderr, "resize to %zu bytes failed\n", size + step);
+            exit(1);
+        }
+        moves += grown != buffer;
+        buffer = grown;
+        buffer[size + step - 1] = 1;  // Touch the new end
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%-10s %8.3f s  %ld of %ld resizes moved the buffer\n", name, elapsed, moves, resizes);
+    my_free(buffer);
+}
+
+// Allocate and free count zeroed blocks of size bytes; returns seconds taken
+double run_calloc(bool use_calloc, long count, size_t size) {
+    double start = now_seconds();
+    for (long i = 0; i < count; i++) {
+        char *block = use_calloc ? my_calloc(1, size) : my_malloc(size);
+        if (!block) {
+            fprintf(stderr, "allocation of %zu bytes failed\n", size);
+            exit(1);
+        }
+        if (!use_calloc) {
+            memset(block, 0, size);
+        }
+        block[i % size] = 1;
+        my_free(block);
+    }
+    return now_seconds() - start;
+}
+
+// Allocate and free at the end of the heap, keeping a few live blocks in front
+void run_tail(long ops, size_t size) {
+    void *live[8];
+    for (int i = 0; i < 8; i++) {
+        live[i] = my_malloc(size);
+    }
+    size_t mmaps = mmap_calls, munmaps = munmap_calls;
+
+    double start = now_seconds();
+    for (long i = 0; i < ops; i++) {
+        char *block = my_malloc(size + i % 64);
+        if (!block) {
+            fprintf(stderr, "allocation of %zu bytes failed\n", size);
+            exit(1);
+        }
+        block[0] = 1;
+        my_free(block);
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%ld malloc/free pairs of %zu bytes: %.1f ns/pair, %zu mmap and %zu munmap calls\n",
+           ops, size, elapsed * 1e9 / ops, mmap_calls - mmaps, munmap_calls - munmaps);
+    for (int i = 0; i < 8; i++) {
+        my_free(live[i]);
+    }
+    printf("my_malloc_trim released %zu bytes\n", my_malloc_trim());
+}
+
+// Allocate count aligned blocks of size bytes, check and report them, then free them
+int run_aligned(size_t alignment, long count, size_t size) {
+    void **blocks = calloc(count, sizeof(void *));
+    long misaligned = 0;
+
+    double start = now_seconds();
+    for (long i = 0; i < count; i++) {
+        blocks[i] = my_aligned_alloc(alignment, size);
+        if (!blocks[i]) {
+            fprintf(stderr, "aligned allocation of %zu bytes failed\n", size);
+            exit(1);
+        }
+        misaligned += ((uintptr_t)blocks[i] & (alignment - 1)) != 0;
+        memset(blocks[i], (int)i, size);
+    }
+    double elapsed = now_seconds() - start;
+
+    struct malloc_stats stats = my_malloc_stats();
+    printf("%5zu-byte alignment: %8.1f ns/alloc  %5.2fx mapped/in use (a page each would be %.2fx)",
+           alignment, elapsed * 1e9 / count, (double)stats.bytes_mapped / stats.bytes_in_use,
+           (double)round_to_page_size(size) / size);
+    if (misaligned) {
+        printf("  %ld misaligned", misaligned);
+    }
+    printf("\n");
+    for (long i = 0; i < count; i++) {
+        my_free(blocks[i]);
+    }
+    free(blocks);
+    return misaligned ? 1 : 0;
+}
+
+// One operation of an allocation trace
+struct trace_op {
+    char kind;             // 'a', 'r' or 'f'
+    long id;
+    size_t size;
+};
+
+// Write the churn sequence of run_churn as a trace; returns false if the file cannot be written
+bool record_trace(const char *path, long ops, int live, size_t max_size) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return false;
+    }
+    bool *used = calloc(live, sizeof(bool));
+    unsigned long long state = 1;
+    fprintf(out, "# churn: %ld ops, %d live blocks, sizes 1..%zu\n", ops, live, max_size);
+    for (long i = 0; i < ops; i++) {
+        int slot = bench_rand(&state) % live;
+        if (used[slot]) {
+            fprintf(out, "f %d\n", slot);
+        }
+        fprintf(out, "a %d %zu\n", slot, 1 + bench_rand(&state) % max_size);
+        used[slot] = true;
+    }
+    for (int slot = 0; slot < live; slot++) {
+        if (used[slot]) {
+            fprintf(out, "f %d\n", slot);
+        }
+    }
+    free(used);
+    return fclose(out) == 0;
+}
+
+// Read a trace into memory so parsing stays out of the timings; returns the operation count
+// and stores the largest ID plus one, or returns -1 on a malformed line
+long load_trace(FILE *in, struct trace_op **ops, long *ids) {
+    long count = 0, capacity = 1024;
+    char line[256];
+    *ops = malloc(capacity * sizeof(struct trace_op));
+    *ids = 0;
+    for (long number = 1; fgets(line, sizeof(line), in); number++) {
+        struct trace_op op = {0, 0, 0};
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        int fields = sscanf(line, " %c %ld %zu", &op.kind, &op.id, &op.size);
+        if (op.id < 0 || !((op.kind == 'f' && fields >= 2) || ((op.kind == 'a' || op.kind == 'r') && fields == 3))) {
+            fprintf(stderr, "line %ld: expected \"a ID SIZE\", \"r ID SIZE\" or \"f ID\"\n", number);
+            return -1;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            *ops = realloc(*ops, capacity * sizeof(struct trace_op));
+        }
+        (*ops)[count++] = op;
+        if (op.id >= *ids) {
+            *ids = op.id + 1;
+        }
+    }
+    return count;
+}
+
+// Replay a trace under one placement policy and print its figures
+void replay_trace(const char *name, enum placement_policy policy, struct trace_op *ops, long count, long ids) {
+    void **slots = calloc(ids, sizeof(void *));
+    size_t peak_mapped = 0, peak_in_use = 0;
+    double fragmentation = 0.0;
+    long samples = 0;
+    my_malloc_set_policy(policy);
+    struct malloc_stats before = my_malloc_stats();
+
+    double start = now_seconds();
+    for (long i = 0; i < count; i++) {
+        struct trace_op *op = &ops[i];
+        if (op->kind == 'f') {
+            my_free(slots[op->id]);
+            slots[op->id] = NULL;
+            continue;
+        }
+        void *ptr = op->kind == 'a' ? my_malloc(op->size) : my_realloc(slots[op->id], op->size);
+        if (!ptr && op->size) {
+            fprintf(stderr, "allocation of %zu bytes failed\n", op->size);
+            exit(1);
+        }
+        if (op->kind == 'a' && slots[op->id]) {
+            my_free(slots[op->id]);  // The trace reused a live ID: the old block leaked in the traced program
+        }
+        slots[op->id] = ptr;
+        if (ptr) {
+            memset(ptr, (int)i, op->size < 64 ? op->size : 64);  // Touch the block
+        }
+        if (heap_bytes_mapped > peak_mapped) {
+            peak_mapped = heap_bytes_mapped;
+        }
+        if (heap_bytes_in_use > peak_in_use) {
+            peak_in_use = heap_bytes_in_use;
+        }
+        if (i % 1024 == 1023) {
+            fragmentation += my_malloc_stats().fragmentation;  // Sampled every 1024 operations
+            samples++;
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%-11s %8.1f ns/op  peak %6.2f MiB mapped for %6.2f MiB in use  fragmentation %5.3f  %7.1f blocks/search\n",
+           name, elapsed * 1e9 / count, peak_mapped / 1048576.0, peak_in_use / 1048576.0,
+           samples ? fragmentation / samples : 0.0, scan_length_since(before));
+    for (long id = 0; id < ids; id++) {
+        my_free(slots[id]);
+    }
+    free(slots);
+    // Start the next policy from an empty heap with small regions again
+    my_malloc_trim();
+    heap_chunk_size = HEAP_CHUNK_MIN;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "aligned") == 0) {
+        long count = argc > 2 ? atol(argv[2]) : 100000;
+        size_t size = argc > 3 ? (size_t)atol(argv[3]) : 256;
+        if (count <= 0 || size == 0) {
+            fprintf(stderr, "Usage: %s aligned [COUNT] [SIZE]\n", argv[0]);
+            return 1;
+        }
+        initialize_page_size();
+        int failed = 0;
+        size_t alignments[] = {32, 64, 4096};
+        for (int a = 0; a < 3; a++) {
+            failed |= run_aligned(alignments[a], count, size);
+        }
+        return failed;
+    }
+    if (argc > 2 && strcmp(argv[1], "record") == 0) {
+        long ops = argc > 3 ? atol(argv[3]) : 200000;
+        int live = argc > 4 ? atoi(argv[4]) : 1000;
+        size_t max_size = argc > 5 ? (size_t)atol(argv[5]) : 8192;
+        if (ops <= 0 || live <= 0 || max_size == 0) {
+            fprintf(stderr, "Usage: %s record FILE [OPS] [LIVE] [MAX_SIZE]\n", argv[0]);
+            return 1;
+        }
+        return record_trace(argv[2], ops, live, max_size) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "trace") == 0) {
+        FILE *in = argc > 2 ? fopen(argv[2], "r") : NULL;
+        if (!in) {
+            fprintf(stderr, "Usage: %s trace FILE\n", argv[0]);
+            return 1;
+        }
+        struct trace_op *ops;
+        long ids;
+        long count = load_trace(in, &ops, &ids);
+        fclose(in);
+        if (count <= 0) {
+            return 1;
+        }
+        const char *names[] = {"first-fit", "next-fit", "best-fit", "segregated"};
+        enum placement_policy policies[] = {FIRST_FIT, NEXT_FIT, BEST_FIT, SEGREGATED_FIT};
+        printf("%ld operations on %ld IDs\n", count, ids);
+        for (int p = 0; p < 4; p++) {
+            replay_trace(names[p], policies[p], ops, count, ids);
+        }
+        free(ops);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "large") == 0) {
+        long ops = argc > 2 ? atol(argv[2]) : 100000;
+        int live = argc > 3 ? atoi(argv[3]) : 1000;
+        if (ops <= 0 || live <= 0) {
+            fprintf(stderr, "Usage: %s large [OPS] [LIVE]\n", argv[0]);
+            return 1;
+        }
+        size_t thresholds[] = {SIZE_MAX, 128 * 1024};
+        const char *names[] = {"no threshold", "128 KiB"};
+        for (int t = 0; t < 2; t++) {
+            double overhead;
+            my_malloc_set_mmap_threshold(thresholds[t]);
+            struct malloc_stats before = my_malloc_stats();
+            double elapsed = run_churn(FIRST_FIT, ops, live, 4096, 16, &overhead);
+            printf("%-12s %8.3f s  %8.1f ns/op  %5.2fx mapped/in use by list blocks  %7.1f blocks/search\n",
+                   names[t], elapsed, elapsed * 1e9 / ops, overhead, scan_length_since(before));
+        }
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "tail") == 0) {
+        long ops = argc > 2 ? atol(argv[2]) : 1000000;
+        size_t size = argc > 3 ? (size_t)atol(argv[3]) : 8192;
+        if (ops <= 0 || size == 0) {
+            fprintf(stderr, "Usage: %s tail [OPS] [SIZE]\n", argv[0]);
+            return 1;
+        }
+        run_tail(ops, size);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "calloc") == 0) {
+        long count = argc > 2 ? atol(argv[2]) : 1000;
+        size_t size = (argc > 3 ? (size_t)atol(argv[3]) : 1024) << 10;
+        if (count <= 0 || size == 0) {
+            fprintf(stderr, "Usage: %s calloc [COUNT] [KB]\n", argv[0]);
+            return 1;
+        }
+        printf("my_calloc        %8.3f s\n", run_calloc(true, count, size));
+        printf("my_malloc+memset %8.3f s\n", run_calloc(false, count, size));
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "realloc") == 0) {
+        size_t max_bytes = (argc > 2 ? (size_t)atol(argv[2]) : 32) << 20;
+        size_t step = (argc > 3 ? (size_t)atol(argv[3]) : 256) << 10;
+        if (max_bytes == 0 || step == 0) {
+            fprintf(stderr, "Usage: %s realloc [MAX_MB] [STEP_KB]\n", argv[0]);
+            return 1;
+        }
+        run_realloc("my_realloc", false, max_bytes, step);
+        run_realloc("copy", true, max_bytes, step);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "threads") == 0) {
+        int max_threads = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        long ops = argc > 3 ? atol(argv[3]) : 1000000;
+        size_t max_size = argc > 4 ? (size_t)atol(argv[4]) : 4096;
+        if (max_threads <= 0 || ops <= 0 || max_size == 0) {
+            fprintf(stderr, "Usage: %s threads [THREADS] [OPS] [MAX_SIZE]\n", argv[0]);
+            return 1;
+        }
+        return run_threads(max_threads, ops, max_size);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "small") == 0) {
+        long count = argc > 2 ? atol(argv[2]) : 100000;
+        size_t size = argc > 3 ? (size_t)atol(argv[3]) : 16;
+        if (count <= 0 || size == 0 || size > 512) {
+            fprintf(stderr, "Usage: %s small [COUNT] [SIZE <= 512]\n", argv[0]);
+            return 1;
+        }
+        run_small("slabs", 512, count, size);
+        run_small("block list", 0, count, size);
+        return 0;
+    }
+
+    long ops = argc > 1 ? atol(argv[1]) : 200000;
+    int live = argc > 2 ? atoi(argv[2]) : 1000;
+    size_t max_size = argc > 3 ? (size_t)atol(argv[3]) : 8192;
+    if (ops <= 0 || live <= 0 || max_size == 0) {
+        fprintf(stderr, "Usage: %s [OPS] [LIVE] [MAX_SIZE]\n", argv[0]);
+        return 1;
+    }
+
+    const char *names[] = {"first-fit", "next-fit", "best-fit", "segregated"};
+    enum placement_policy policies[] = {FIRST_FIT, NEXT_FIT, BEST_FIT, SEGREGATED_FIT};
+    printf("%ld ops, %d live blocks, sizes 1..%zu\n", ops, live, max_size);
+    for (int p = 0; p < 4; p++) {
+        double overhead;
+        struct malloc_stats before = my_malloc_stats();
+        double elapsed = run_churn(policies[p], ops, live, max_size, 0, &overhead);
+        printf("%-12s %8.3f s  %8.1f ns/op  %5.2fx mapped/in use  %7.1f blocks/search\n", names[p], elapsed,
+               elapsed * 1e9 / ops, overhead, scan_length_since(before));
+    }
+    my_malloc_print_stats(stdout);
+    return 0;
+}